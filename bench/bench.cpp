@@ -0,0 +1,646 @@
+/**
+ * @file bench.cpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Headless benchmarks of the window, menu and input hot paths; run with `make bench`.
+ * @version See Git tags for version information.
+ * @date 2026.10.16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <ncurses.h>
+#include <menu.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "mebgui.hpp"
+#include "meb_anim.hpp"
+#include "meb_cells.hpp"
+#include "meb_plot.hpp"
+#include "meb_record.hpp"
+#include "meb_render.hpp"
+#include "meb_scrollview.hpp"
+#include "meb_share.hpp"
+#include "meb_stats.hpp"
+#include "meb_table.hpp"
+#include "meb_textview.hpp"
+
+// Timed passes per benchmark; the fastest is reported.
+#define BENCH_REPEATS 5
+// Fixed so byte counts do not depend on the terminal the benchmark is started from.
+#define BENCH_TERM "xterm"
+#define BENCH_COLS "160"
+#define BENCH_LINES "50"
+// Changes beyond this are flagged when comparing against a baseline.
+#define BENCH_TOLERANCE 0.10
+
+/*
+ * Results are printed one per line as "<name> <value> <unit>", in a fixed order, so two runs can be compared with
+ * diff(1) or by passing an earlier run's output as the only argument. Times are the fastest of BENCH_REPEATS passes;
+ * bytes and write(...) calls come from MEBStats in a separate pass, since measuring them costs system calls of its own.
+ */
+
+static std::vector<std::string> results;
+
+static double now_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void report(const char *name, double value, const char *unit)
+{
+    char line[128];
+    snprintf(line, sizeof(line), "%-36s %14.1f %s", name, value, unit);
+    results.push_back(line);
+}
+
+// Runs op(i) for i in [0, n), BENCH_REPEATS times, and returns the fastest pass in nanoseconds per operation.
+template <typename F>
+static double time_op(int n, F op)
+{
+    double best = 0;
+    for (int r = 0; r < BENCH_REPEATS; r++)
+    {
+        double start = now_ns();
+        for (int i = 0; i < n; i++)
+            op(i);
+        double t = (now_ns() - start) / n;
+        if (r == 0 || t < best)
+            best = t;
+    }
+    return best;
+}
+
+// Runs op(i) for i in [0, n) once more, and reports the terminal output and frames per operation.
+template <typename F>
+static void count_op(const char *name, int n, F op)
+{
+    MEBStats *stats = MEBStats::Get();
+    stats->Enable(true);
+    MEBScreenCounters before = stats->Counters();
+    for (int i = 0; i < n; i++)
+        op(i);
+    MEBScreenCounters after = stats->Counters();
+    stats->Enable(false);
+
+    std::string s(name);
+    report((s + ".bytes").c_str(), (double)(after.bytes_written - before.bytes_written) / n, "B/op");
+    report((s + ".writes").c_str(), (double)(after.write_calls - before.write_calls) / n, "writes/op");
+    report((s + ".frames").c_str(), (double)(after.frames - before.frames) / n, "frames/op");
+}
+
+template <typename F>
+static void bench(const char *name, int n, F op)
+{
+    report(name, time_op(n, op), "ns/op");
+    count_op(name, n, op);
+}
+
+// Moving and refreshing windows, in place and by recreating them.
+static void bench_windows()
+{
+    const bool modes[] = {true, false};
+    const char *names[] = {"damage", "recreate"};
+
+    for (int m = 0; m < 2; m++)
+    {
+        MEBWindow::SetDamageTracking(modes[m]);
+        MEBWindow *under = new MEBWindow(0, 0, 120, 40, "Under");
+        MEBWindow *w = new MEBWindow(10, 5, 40, 12, "Bench");
+        std::string prefix = std::string("window.") + names[m];
+
+        bench((prefix + ".move").c_str(), 20000, [&](int i)
+              { w->Move(i % 2 ? -1 : 1, 0); });
+        bench((prefix + ".resize").c_str(), 20000, [&](int i)
+              { w->Resize(i % 2 ? -1 : 1, 0); });
+        bench((prefix + ".refresh").c_str(), 20000, [&](int i)
+              { w->Refresh(); });
+
+        delete w;
+        delete under;
+    }
+    MEBWindow::SetDamageTracking(true);
+}
+
+// Whole frames: with nothing to do, and with a line of text changed.
+static void bench_frames()
+{
+    MEBWindow *w = new MEBWindow(10, 5, 40, 12, "Bench");
+
+    bench("frame.idle", 50000, [&](int i)
+          { MEBScreen::Get()->BeginFrame(); MEBScreen::Get()->EndFrame(); });
+    bench("frame.text", 50000, [&](int i)
+          {
+              MEBScreen::Get()->BeginFrame();
+              mvwprintw(w->win, 2, 2, "Counter: %8d", i);
+              MEBScreen::Get()->EndFrame(); });
+
+    // The same, with the window wholly hidden by another.
+    MEBWindow *cover = new MEBWindow(5, 2, 60, 20, "Cover");
+    bench("frame.hidden", 50000, [&](int i)
+          {
+              MEBScreen::Get()->BeginFrame();
+              mvwprintw(w->win, 2, 2, "Counter: %8d", i);
+              MEBScreen::Get()->EndFrame(); });
+
+    delete cover;
+    delete w;
+}
+
+// Four moves of a window, made directly, each output as it is made, and through a MEBAnimator, output as one.
+static void bench_anim()
+{
+    MEBWindow *under = new MEBWindow(0, 0, 120, 40, "Under");
+    MEBWindow *w = new MEBWindow(10, 5, 40, 12, "Bench");
+    MEBAnimator anim;
+
+    bench("window.moves4.direct", 20000, [&](int i)
+          {
+              for (int k = 0; k < 4; k++)
+                  w->Move(i % 2 ? -1 : 1, k % 2 ? -1 : 1); });
+    bench("window.moves4.anim", 20000, [&](int i)
+          {
+              for (int k = 0; k < 4; k++)
+                  anim.Move(w, i % 2 ? -1 : 1, k % 2 ? -1 : 1);
+              anim.Tick(true); });
+
+    delete w;
+    delete under;
+}
+
+// A 100k-row, 20-column table: frames changing 200 cells anywhere in it, and frames scrolling it by a row.
+static void bench_table()
+{
+    MEBWindow *w = new MEBWindow(0, 0, 160, 50, "Table");
+    MEBTable *t = new MEBTable(w, 1, 1, 158, 48);
+    for (int c = 0; c < 20; c++)
+        t->AddColumn("counter", MEB_COLUMN_INT, 8);
+    t->SetRowCount(100000);
+
+    MEBScreen::Get()->BeginFrame();
+    for (int r = 0; r < 100000; r++)
+        for (int c = 0; c < 20; c++)
+            t->SetInt(r, c, (r * 31 + c * 7) % 100000);
+    MEBScreen::Get()->EndFrame();
+
+    // Every pass runs the same cells, so the values count up across passes to keep changing.
+    int64_t value = 0;
+    bench("table.update", 2000, [&](int i)
+          {
+              MEBScreen::Get()->BeginFrame();
+              for (int k = 0; k < 200; k++)
+              {
+                  unsigned h = (i * 200 + k) * 2654435761u;
+                  t->SetInt((h >> 8) % 100000, h % 20, value++);
+              }
+              MEBScreen::Get()->EndFrame(); });
+    bench("table.scroll", 2000, [&](int i)
+          { t->Scroll(i % 2 ? -1 : 1, 0); });
+
+    delete t;
+    delete w;
+}
+
+// A 64 MiB file of short lines: indexing it, jumping to lines anywhere in it, and scrolling.
+static void bench_textview()
+{
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/meb_bench_text.%d", (int)getpid());
+    FILE *fp = fopen(path, "w");
+    if (fp == NULL)
+        return;
+    uint64_t n_lines = 0;
+    for (long bytes = 0; bytes < (64 << 20); n_lines++)
+        bytes += fprintf(fp, "%08llu %.*s\n", (unsigned long long)n_lines, (int)(n_lines % 40), "0123456789abcdef0123456789abcdef01234567");
+    fclose(fp);
+
+    MEBWindow *w = new MEBWindow(0, 0, COLS, LINES, "Text");
+    double start = now_ns();
+    MEBTextView *v = new MEBTextView(w, 1, 1, COLS - 2, LINES - 2, path);
+    while (!v->Indexed())
+        usleep(100);
+    report("textview.index", v->Size() / ((now_ns() - start) / 1e9) / (1 << 20), "MiB/s");
+
+    bench("textview.goto", 20000, [&](int i)
+          { v->GoToLine((i * 2654435761u) % n_lines); });
+    bench("textview.scroll", 20000, [&](int i)
+          { v->Scroll(i % 2 ? -1 : 1, 0); });
+
+    delete v;
+    delete w;
+    unlink(path);
+}
+
+// A 160-column plot: pushing batches of 4096 samples, and frames each scrolling it by a column of 4096.
+static void bench_plot()
+{
+    MEBWindow *w = new MEBWindow(0, 0, 162, 12, "Plot");
+    MEBPlot *p = new MEBPlot(w, 1, 1, 160, 10, 4096);
+    std::vector<float> samples(4096);
+    for (size_t i = 0; i < samples.size(); i++)
+        samples[i] = (float)((i * 2654435761u) % 1000);
+
+    report("plot.push4096", time_op(2000, [&](int i)
+                                    { p->Push(samples.data(), samples.size()); }) /
+                                4096,
+           "ns/sample");
+
+    // Every pass runs the same i, so a counter keeps the columns differing.
+    int tick = 0;
+    bench("plot.frame", 2000, [&](int i)
+          {
+              samples[0] = (float)(tick++ % 1500);
+              p->Push(samples.data(), samples.size());
+              MEBScreen::Get()->Present(); });
+
+    delete p;
+    delete w;
+}
+
+// Building a frame in memory, diffing it against the last, and snapshotting the screen.
+static void bench_cells()
+{
+    MEBWindow *w = new MEBWindow(10, 5, 40, 12, "Bench");
+    MEBCellBuffer frame(COLS, LINES), prev(COLS, LINES), snap;
+
+    report("cells.build", time_op(20000, [&](int i)
+                                  {
+                                      frame.Clear();
+                                      frame.Box(0, 0, 60, 20);
+                                      for (int r = 1; r < 19; r++)
+                                          frame.Printf(2, r, A_NORMAL, "Row %2d: %8d", r, i); }),
+           "ns/op");
+    report("cells.diff", time_op(20000, [&](int i)
+                                 {
+                                     std::vector<MEBRect> spans;
+                                     prev.Put(i % COLS, i % LINES, 'x');
+                                     frame.Diff(prev, spans); }),
+           "ns/op");
+    report("cells.snapshot", time_op(20000, [&](int i)
+                                     { MEBScreen::Get()->Snapshot(snap); }),
+           "ns/op");
+
+    delete w;
+}
+
+// Frames in which every row of a full-screen window changes, output by NCURSES, by a MEBRenderer, and by one on a 64 kbit/s link.
+static void bench_churn(int out_fd)
+{
+    MEBWindow *w = new MEBWindow(0, 0, COLS, LINES, "Churn");
+    MEBRenderer *native = new MEBRenderer(out_fd);
+    MEBRenderer *slow = new MEBRenderer(out_fd);
+    slow->SetLinkRate(8000); // 64 kbit/s, so most frames are dropped.
+    MEBRenderer *renderers[] = {nullptr, native, slow};
+    const char *names[] = {"frame.churn.ncurses", "frame.churn.native", "frame.churn.64k"};
+
+    for (int m = 0; m < 3; m++)
+    {
+        MEBScreen::Get()->SetRenderer(renderers[m]);
+        bench(names[m], 2000, [&](int i)
+              {
+                  MEBScreen::Get()->BeginFrame();
+                  for (int r = 1; r < LINES - 1; r++)
+                  {
+                      wattrset(w->win, (r + i) % 7 == 0 ? A_REVERSE : A_NORMAL);
+                      mvwprintw(w->win, r, 1, "%4d", r);
+                      for (int c = 5; c < COLS - 1; c += 10)
+                          wprintw(w->win, " %9x", (unsigned)(i * 2654435761u + r * c));
+                  }
+                  wattrset(w->win, A_NORMAL);
+                  MEBScreen::Get()->EndFrame(); });
+    }
+
+    MEBScreen::Get()->SetRenderer(nullptr);
+    delete native;
+    delete slow;
+    delete w;
+}
+
+// A full-screen view onto 4096 rows, scrolling a line per frame: output by NCURSES, by a MEBRenderer scrolling the
+// terminal, and by one repainting the whole view each time.
+static void bench_scroll(int out_fd)
+{
+    MEBWindow *w = new MEBWindow(0, 0, COLS, LINES, "Scroll");
+    MEBScrollView *v = new MEBScrollView(w, 1, 1, COLS - 2, LINES - 2, COLS - 2, 4096);
+    for (int r = 0; r < v->ContentRows(); r++)
+    {
+        wattrset(v->Pad(), r % 7 == 0 ? A_REVERSE : A_NORMAL);
+        mvwprintw(v->Pad(), r, 0, "%4d", r);
+        for (int c = 4; c < v->ContentCols() - 10; c += 10)
+            wprintw(v->Pad(), " %9x", (unsigned)(r * 2654435761u + c));
+    }
+    wattrset(v->Pad(), A_NORMAL);
+
+    MEBRenderer *native = new MEBRenderer(out_fd);
+    MEBRenderer *renderers[] = {nullptr, native, native};
+    const char *names[] = {"scroll.ncurses", "scroll.native", "scroll.repaint"};
+    int steps = v->ContentRows() - (LINES - 2);
+
+    for (int m = 0; m < 3; m++)
+    {
+        MEBScreen::Get()->SetRenderer(renderers[m]);
+        bench(names[m], 2000, [&](int i)
+              {
+                  MEBScreen::Get()->BeginFrame();
+                  v->ScrollTo(i % steps, 0);
+                  if (m == 2)
+                      v->Refresh();
+                  MEBScreen::Get()->EndFrame(); });
+    }
+
+    MEBScreen::Get()->SetRenderer(nullptr);
+    delete native;
+    delete v;
+    delete w;
+}
+
+// The churn frames again, shared with eight viewers which read everything they are sent.
+static void bench_share()
+{
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/meb_bench_share.%d", (int)getpid());
+    MEBShare *share = new MEBShare(path);
+
+    std::vector<int> viewers;
+    struct sockaddr_un addr = {};
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+    for (int v = 0; v < 8; v++)
+    {
+        int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0);
+        if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) == 0)
+            viewers.push_back(fd);
+        else
+            close(fd);
+    }
+
+    MEBWindow *w = new MEBWindow(0, 0, COLS, LINES, "Share");
+    MEBScreen::Get()->SetShare(share);
+    char sink[65536];
+    bench("frame.share.8", 2000, [&](int i)
+          {
+              MEBScreen::Get()->BeginFrame();
+              for (int r = 1; r < LINES - 1; r++)
+              {
+                  mvwprintw(w->win, r, 1, "%4d", r);
+                  for (int c = 5; c < COLS - 1; c += 10)
+                      wprintw(w->win, " %9x", (unsigned)(i * 2654435761u + r * c));
+              }
+              MEBScreen::Get()->EndFrame();
+              for (int fd : viewers)
+                  while (read(fd, sink, sizeof(sink)) > 0)
+                      ; });
+    report("frame.share.8.encoded", (double)share->BytesEncoded() / share->Frames(), "B/frame");
+
+    MEBScreen::Get()->SetShare(nullptr);
+    delete w;
+    for (int fd : viewers)
+        close(fd);
+    delete share;
+}
+
+// The churn frames recorded, then played back as fast as possible, and so is any recording named by BENCH_REC.
+static void bench_replay()
+{
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/meb_bench_replay.%d", (int)getpid());
+
+    MEBWindow *w = new MEBWindow(0, 0, COLS, LINES, "Replay");
+    MEBRecorder *rec = new MEBRecorder(path);
+    MEBScreen::Get()->SetRecorder(rec);
+    bench("frame.record", 500, [&](int i)
+          {
+              MEBScreen::Get()->BeginFrame();
+              for (int r = 1; r < LINES - 1; r++)
+              {
+                  wattrset(w->win, (r + i) % 7 == 0 ? A_REVERSE : A_NORMAL);
+                  mvwprintw(w->win, r, 1, "%4d", r);
+                  for (int c = 5; c < COLS - 1; c += 10)
+                      wprintw(w->win, " %9x", (unsigned)(i * 2654435761u + r * c));
+              }
+              wattrset(w->win, A_NORMAL);
+              MEBScreen::Get()->EndFrame(); });
+    MEBScreen::Get()->SetRecorder(nullptr);
+    report("frame.record.size", (double)rec->Bytes() / rec->Frames(), "B/frame");
+    delete rec;
+
+    const char *names[] = {"frame.replay", "frame.replay.rec"};
+    const char *paths[] = {path, getenv("BENCH_REC")};
+    for (int m = 0; m < 2; m++)
+    {
+        if (paths[m] == NULL || paths[m][0] == '\0')
+            continue;
+
+        MEBReplay *replay = new MEBReplay(paths[m], w);
+        bench(names[m], replay->Frames(), [&](int i)
+              {
+                  if (!replay->Step())
+                  {
+                      replay->Rewind();
+                      replay->Step();
+                  } });
+        delete replay;
+    }
+
+    unlink(path);
+    delete w;
+}
+
+// Constructing menus, and moving through them, by item count.
+static void bench_menus()
+{
+    const int counts[] = {10, 100, 1000, 10000};
+    MEBWindow *w = new MEBWindow(0, 0, 60, 24, "Menu");
+
+    for (size_t c = 0; c < ARRAY_SIZE(counts); c++)
+    {
+        int n = counts[c];
+        std::vector<std::string> text(n);
+        std::vector<char *> titles(n), descs(n);
+        for (int i = 0; i < n; i++)
+        {
+            char buf[32];
+            snprintf(buf, sizeof(buf), "Item %d", i);
+            text[i] = buf;
+            titles[i] = descs[i] = &text[i][0];
+        }
+
+        char name[64];
+        int reps = 20000 / n;
+
+        // Only the constructor is timed.
+        double best = 0;
+        for (int r = 0; r < BENCH_REPEATS; r++)
+        {
+            double t = 0;
+            for (int i = 0; i < reps; i++)
+            {
+                double start = now_ns();
+                MEBMenu *m = new MEBMenu(w, 2, 2, 50, 18, n, &titles[0], &descs[0], "*");
+                t += now_ns() - start;
+                delete m;
+            }
+            t /= reps;
+            if (r == 0 || t < best)
+                best = t;
+        }
+        snprintf(name, sizeof(name), "menu.construct.%d", n);
+        report(name, best, "ns/op");
+
+        // Down to the last item and back up again, scrolling as a user would.
+        MEBMenu *m = new MEBMenu(w, 2, 2, 50, 18, n, &titles[0], &descs[0], "*");
+        int steps = 2 * (n - 1);
+        snprintf(name, sizeof(name), "menu.navigate.%d", n);
+        bench(name, steps, [&](int i)
+              { m->Update(i < n - 1 ? KEY_DOWN : KEY_UP); });
+
+        // A held arrow key: 37 repeats read in one frame, down and then back up.
+        snprintf(name, sizeof(name), "menu.burst.%d", n);
+        bench(name, 200, [&](int i)
+              {
+                  MEBScreen::Get()->BeginFrame();
+                  for (int k = 0; k < 37; k++)
+                      m->Update(i % 2 ? KEY_UP : KEY_DOWN);
+                  MEBScreen::Get()->EndFrame(); });
+        delete m;
+    }
+
+    delete w;
+}
+
+// Decoding keys, as the event loop does, from a pipe standing in for the terminal.
+static void bench_input(int keys_fd)
+{
+    const char *seq = "\x1bOB";
+    const int batch = 4096;
+
+    std::string buf;
+    for (int i = 0; i < batch; i++)
+        buf += seq;
+
+    // Each batch fits in the pipe, so writing never blocks.
+    double t = time_op(16, [&](int)
+                       {
+                           if (write(keys_fd, buf.data(), buf.size()) != (ssize_t)buf.size())
+                               return;
+                           while (wgetch(stdscr) != ERR)
+                               ; });
+    report("input.decode", t / batch, "ns/key");
+}
+
+// Compares against an earlier run, flagging changes beyond BENCH_TOLERANCE.
+static int compare(const char *path)
+{
+    FILE *fp = fopen(path, "r");
+    if (fp == NULL)
+    {
+        perror(path);
+        return 1;
+    }
+
+    std::map<std::string, double> baseline;
+    char name[128], unit[32];
+    double value;
+    char line[256];
+    while (fgets(line, sizeof(line), fp) != NULL)
+    {
+        if (line[0] != '#' && sscanf(line, "%127s %lf %31s", name, &value, unit) == 3)
+            baseline[name] = value;
+    }
+    fclose(fp);
+
+    int flagged = 0;
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        sscanf(results[i].c_str(), "%127s %lf %31s", name, &value, unit);
+        if (baseline.count(name) == 0)
+            continue;
+
+        double old = baseline[name];
+        double change = old != 0 ? (value - old) / old : (value != 0 ? 1 : 0);
+        if (change > BENCH_TOLERANCE || change < -BENCH_TOLERANCE)
+        {
+            fprintf(stderr, "%-36s %14.1f -> %14.1f %s (%+.0f%%)\n", name, old, value, unit, change * 100);
+            flagged++;
+        }
+    }
+    fprintf(stderr, "%d of %zu results changed by more than %.0f%%.\n", flagged, results.size(), BENCH_TOLERANCE * 100);
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    setenv("COLUMNS", BENCH_COLS, 1);
+    setenv("LINES", BENCH_LINES, 1);
+
+    // Output is discarded; input comes from a pipe the input benchmark writes to.
+    int keys[2];
+    FILE *out = fopen("/dev/null", "w");
+    if (out == NULL || pipe(keys) != 0)
+    {
+        perror("bench");
+        return 1;
+    }
+    FILE *in = fdopen(keys[0], "r");
+
+    SCREEN *scr = newterm(BENCH_TERM, out, in);
+    if (scr == NULL)
+    {
+        fprintf(stderr, "bench: cannot open terminal type " BENCH_TERM ".\n");
+        return 1;
+    }
+    cbreak();
+    noecho();
+    keypad(stdscr, TRUE);
+    nodelay(stdscr, TRUE);
+    refresh();
+
+    bench_windows();
+    bench_frames();
+    bench_anim();
+    bench_table();
+    bench_textview();
+    bench_plot();
+    bench_cells();
+    bench_churn(fileno(out));
+    bench_scroll(fileno(out));
+    bench_share();
+    bench_replay();
+    bench_menus();
+    bench_input(keys[1]);
+
+    endwin();
+    delscreen(scr);
+    fclose(out);
+
+    printf("# mebgui benchmark results: <name> <value> <unit>\n");
+    printf("# terminal " BENCH_TERM " " BENCH_COLS "x" BENCH_LINES ", " NCURSES_VERSION "\n");
+    for (size_t i = 0; i < results.size(); i++)
+        printf("%s\n", results[i].c_str());
+
+    return argc > 1 ? compare(argv[1]) : 0;
+}
@@ -19,10 +19,24 @@
 #include <string.h>
 #include <math.h>
 #include <unistd.h>
+#include <atomic>
 
 #include "mebgui.hpp"
+#include "meb_anim.hpp"
+#include "meb_eventloop.hpp"
+#include "meb_input.hpp"
+#include "meb_layout.hpp"
+#include "meb_queue.hpp"
+#include "meb_log.hpp"
+#include "meb_record.hpp"
+#include "meb_share.hpp"
+#include "meb_stats.hpp"
 #include "guimain.hpp"
 
+// Hand debug output to a background writer, so it can be shown in a log pane instead of over the screen.
+#define MEB_PRINT_ASYNC
+#include "meb_print.h"
+
 ///////////////////////////////////////
 /// USER DEFINED EXAMPLE CODE BELOW ///
 ///////////////////////////////////////
@@ -45,18 +59,8 @@ char *menu1_choices_desc[] = {
     (char *)NULL,
 };
 
-// Enables the graceful handling of Ctrl+C and other program-ending key combinations.
-volatile sig_atomic_t done;
-void sighandler(int sig)
-{
-    done = 1;
-}
-
 int main()
 {
-    // Signal handler for Ctrl+C, etc.
-    signal(SIGINT, sighandler);
-
     // Fetch current terminal dimensions.
     int t_cols = 0, t_rows = 0;
     getmaxyx(stdscr, t_rows, t_cols);
@@ -64,6 +68,29 @@ int main()
     // Initial setup.
     ncurses_init(DEFAULT_W_TIMEOUT);
 
+    // Move and resize windows in place, repainting only what changed.
+    MEBWindow::SetDamageTracking(true);
+
+    // Sleeps until there is input, a signal or a timer to handle. Ctrl+C, etc, stop the loop gracefully.
+    MEBEventLoop loop;
+
+    // Set MEB_SHARE to a socket path to let others watch, e.g. with socat -u UNIX-CONNECT:<path> STDOUT.
+    MEBShare *share = nullptr;
+    if (getenv("MEB_SHARE") != NULL)
+    {
+        share = new MEBShare(getenv("MEB_SHARE"));
+        share->Attach(&loop);
+        MEBScreen::Get()->SetShare(share);
+    }
+
+    // Set MEB_RECORD to a file path to record the session, for replay.out to play back.
+    MEBRecorder *recorder = nullptr;
+    if (getenv("MEB_RECORD") != NULL)
+    {
+        recorder = new MEBRecorder(getenv("MEB_RECORD"));
+        MEBScreen::Get()->SetRecorder(recorder);
+    }
+
     // Windows instantiation.
     // Draws a 10x10 window at (0, 0) with title "My Window".
     MEBWindow *win1 = new MEBWindow(0, 0, 10, 10, "My Window");
@@ -72,91 +99,176 @@ int main()
     MEBWindow *win2 = new MEBWindow(0, 0, 10, 10, "Child Window", win1);
 
     MEBWindow *win3 = new MEBWindow(25, 10, 60, 20, "Input Window");
+
+    // Keeps the input window in the bottom-right corner as the Terminal is resized.
+    MEBLayout layout(MEB_LAYOUT_COLUMN);
+    layout.AddSpace(MEBConstraint::Flex());
+    MEBLayout *bottom = layout.AddSplit(MEB_LAYOUT_ROW, MEBConstraint::Fixed(20));
+    bottom->AddSpace(MEBConstraint::Flex());
+    bottom->AddWindow(win3, MEBConstraint::Fixed(60));
+    MEBScreen::Get()->SetLayout(&layout);
+
     MEBMenu *mebmenu1 = new MEBMenu(win3, 2, 2, 25, 6, ARRAY_SIZE(menu1_choices), menu1_choices, menu1_choices_desc, "*");
 
+    // A log pane any thread can append to; keeps the last 1000 lines.
+    MEBLogWindow *log1 = new MEBLogWindow(win3, 2, 15, 56, 4, 1000);
+    log1->Attach(&loop);
+    meb_print_set_sink([](void *ctx, int stream, const char *line)
+                       { ((MEBLogWindow *)ctx)->Append(line); },
+                       log1);
+
     // Main loop variables.
     char user_input_string[256] = {0};
-    int in;
-    int sel = -1;
+    const char *input_fmt = "%s";
 
-    // Main loop.
-    while (!done)
-    {
-        // Retrieves any single keypress, and can detect Terminal resizing.
-        in = wgetch(stdscr);
+    // Takes a line of input without stopping the rest of the screen; focused by choices 3 and 4.
+    MEBInputField *field1 = new MEBInputField(win3, 2, 10, 56, "Input: ", sizeof(user_input_string) - 1);
+    field1->OnSubmit([&](const char *line)
+                     {
+        user_input_string[0] = '\0';
+        field1->Scan(input_fmt, user_input_string);
+        mvwprintw(field1->GetParent()->win, 11, 2, ">> %-52s", user_input_string);
+        field1->Focus(false); });
+    MEBStatsHUD *hud = nullptr;
+
+    // Called for every keypress, including KEY_RESIZE when the Terminal is resized.
+    loop.OnKey([&](int in)
+               {
+        // F2 toggles a live overlay of rendering statistics.
+        if (in == KEY_F(2))
+        {
+            if (hud != nullptr)
+            {
+                delete (hud);
+                hud = nullptr;
+            }
+            else
+                hud = new MEBStatsHUD(t_cols - 41, 0);
+            return;
+        }
+
+        // While the input field is focused it takes every key it can use.
+        if (field1->Update(in))
+            return;
 
         // Updates the menu. Will return which choice the user has selected (-1 if none selected).
-        sel = mebmenu1->Update(in);
+        int sel = mebmenu1->Update(in);
 
         // Determines actions based on which menu item was selected, if any.
         switch (sel)
         {
         case 0:
             mebmenu1->GetParent()->Move(0, 1);
-            mebmenu1->Refresh();
             break;
         case 1:
             mebmenu1->GetParent()->Move(0, -1);
-            mebmenu1->Refresh();
             break;
         case 2:
             // Input example, reads until whitespace.
-            input(mebmenu1->GetParent(), 10, 2, "Input: ", "%s", user_input_string);
-            mvwprintw(mebmenu1->GetParent()->win, 11, 2, ">> %s", user_input_string);
-            wrefresh(mebmenu1->GetParent()->win);
+            input_fmt = "%255s";
+            field1->Focus(true);
             break;
         case 3:
             // Input example which reads in 255 bytes until a newline.
-            input(mebmenu1->GetParent(), 10, 2, "Input: ", "%255[^\n]", user_input_string);
-            mvwprintw(mebmenu1->GetParent()->win, 11, 2, ">> %s", user_input_string);
-            wrefresh(mebmenu1->GetParent()->win);
+            input_fmt = "%255[^\n]";
+            field1->Focus(true);
             break;
         case 4:
-            goto program_end;
-        }
-        
-        // This is where Terminal resizing should be handled if necessary. This usually entails refreshing or moving windows. 
-        if (in == KEY_RESIZE)
-        {
-            // NOTE: !!! Everything that needs to be redrawn, etc, on resize needs to be done here.
-        }
+            loop.Stop();
+            break;
+        } });
+
+    // This is where Terminal resizing should be handled if necessary. Windows in the layout are placed automatically.
+    loop.OnResize([&](int cols, int rows)
+                  {
+        t_cols = cols;
+        t_rows = rows; });
+
+    // Moves are applied at most 60 times a second, however often they are requested.
+    MEBAnimator anim;
+    anim.Attach(&loop);
 
-        // Code which detects the edge of the Terminal, moving and bouncing two windows.
+    // Code which detects the edge of the Terminal, moving and bouncing two windows, 100 times a second.
+    loop.AddTimer(10, [&]()
+                  {
         static int forward = 1;
-        if (win1->X() + win1->Cols() > t_cols)
+        // Where the window is headed, as moves made since the last frame have not been applied yet.
+        MEBRect to = anim.Target(win1);
+        if (to.x + to.cols > t_cols)
             forward = 0;
-        else if (win1->X() < 1)
+        else if (to.x < 1)
             forward = 1;
+        // The child window follows its parent.
         if (forward)
         {
-            win1->Move(1, 0);
+            anim.Move(win1, 1, 0);
         }
         else
         {
-            win1->Move(-1, 0);
-        }
-        win2->Refresh();
-        
-        // Gets and stores the current width (in columns) and height (in rows) of the Terminal.
-        getmaxyx(stdscr, t_rows, t_cols);
+            anim.Move(win1, -1, 0);
+        } });
 
-        usleep(10000);
-    }
+    // Gets and stores the current width (in columns) and height (in rows) of the Terminal.
+    getmaxyx(stdscr, t_rows, t_cols);
 
-program_end:
+    // Worker threads never touch NCURSES themselves; they post to the UI thread instead.
+    MEBCommandQueue queue;
+    queue.Attach(&loop);
+
+    std::atomic<bool> worker_done(false);
+    pthread_t worker_tid;
+    struct worker_args
+    {
+        MEBCommandQueue *queue;
+        MEBWindow *win;
+        std::atomic<bool> *done;
+    } wargs = {&queue, win3, &worker_done};
+    pthread_create(
+        &worker_tid, NULL, [](void *arg) -> void *
+        {
+            worker_args *a = (worker_args *)arg;
+            for (unsigned long counter = 0; !*a->done; counter++)
+            {
+                // Posted far faster than the screen updates; only the latest value is drawn each frame.
+                a->queue->PostPrint(a->win, 2, 14, "Worker counter: %lu", counter);
+                if (counter % 1000 == 0)
+                    tprintlf("Worker passed %lu.", counter);
+                usleep(100);
+            }
+            return NULL; },
+        &wargs);
+
+    // Main loop. Each wake-up is drawn as a single frame.
+    loop.Run();
+
+    worker_done = true;
+    pthread_join(worker_tid, NULL);
+
+    // Set MEB_STATS_DUMP to a file path, or unix:<socket path>, to collect the statistics at exit.
+    if (getenv("MEB_STATS_DUMP") != NULL)
+        MEBStats::Get()->Dump(getenv("MEB_STATS_DUMP"));
 
     // Cleanup.
+    MEBScreen::Get()->SetShare(nullptr);
+    delete (share);
+    MEBScreen::Get()->SetRecorder(nullptr);
+    delete (recorder);
+    MEBScreen::Get()->SetLayout(nullptr);
+    anim.Cancel(win1);
+    // Widgets first, since they draw into sub-windows of their windows.
+    delete (hud);
+    delete (field1);
+    delete (mebmenu1);
+    meb_print_set_sink(NULL, NULL);
+    delete (log1);
+
     delete (win1);
     delete (win2);
     delete (win3);
 
-    delete (mebmenu1);
-
     ncurses_cleanup();
 
-    done = 1;
-
     printf("Everything is OK.\n");
 
     return 0;
-}
\ No newline at end of file
+}
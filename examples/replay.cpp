@@ -0,0 +1,103 @@
+/**
+ * @file replay.cpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Plays back a session recorded with MEBRecorder, and reports what drawing it cost.
+ * @version See Git tags for version information.
+ * @date 2026.10.16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * MIT License
+ *
+ */
+
+#include <ncurses.h>
+#include <menu.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdexcept>
+
+#include "mebgui.hpp"
+#include "meb_eventloop.hpp"
+#include "meb_record.hpp"
+#include "meb_stats.hpp"
+
+// Usage: replay.out <recording> [speed]
+// A speed of 1 plays at the recorded pace, 2 at twice it, and 0 as fast as possible. 'q' stops a paced replay early.
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "Usage: %s <recording> [speed]\n", argv[0]);
+        return 1;
+    }
+    double speed = argc > 2 ? atof(argv[2]) : 1;
+
+    ncurses_init(DEFAULT_W_TIMEOUT);
+    // Only a paced replay needs the loop, which also holds back Ctrl+C to stop gracefully.
+    MEBEventLoop *loop = speed > 0 ? new MEBEventLoop() : nullptr;
+    MEBStats::Get()->Enable(true);
+
+    MEBWindow *view = new MEBWindow(0, 0, COLS, LINES, "Replay");
+    MEBReplay *replay = nullptr;
+    try
+    {
+        replay = new MEBReplay(argv[1], view);
+    }
+    catch (const std::exception &e)
+    {
+        delete view;
+        delete loop;
+        ncurses_cleanup();
+        fprintf(stderr, "%s: %s\n", argv[1], e.what());
+        return 1;
+    }
+
+    uint64_t start = MEBStats::Get()->Now();
+    if (loop != nullptr)
+    {
+        loop->OnKey([&](int in)
+                    {
+            if (in == 'q')
+                loop->Stop(); });
+        loop->OnQuit([&](int sig)
+                     { loop->Stop(); });
+        loop->AddTimer(100, [&]()
+                       {
+            if (replay->Done())
+                loop->Stop(); });
+
+        replay->SetSpeed(speed);
+        replay->Attach(loop);
+        loop->Run();
+    }
+    else
+    {
+        // Every recorded frame is output as a frame of its own, with nothing else in between.
+        while (replay->Step())
+            ;
+    }
+    uint64_t took = MEBStats::Get()->Now() - start;
+
+    MEBScreenCounters c = MEBStats::Get()->Counters();
+    uint64_t played = replay->Played();
+    uint64_t keys = replay->Keys();
+    double recorded = replay->DurationUs() / 1e6;
+
+    delete replay;
+    delete view;
+    delete loop;
+    ncurses_cleanup();
+
+    // To stderr, since the screen is drawn to stdout; in the benchmark's format, so runs with two builds of the library
+    // can be compared with diff(1).
+    fprintf(stderr, "# %s: %llu frames, %llu keys, %.3f s recorded, played at %gx\n", argv[1], (unsigned long long)played,
+           (unsigned long long)keys, recorded, speed);
+    fprintf(stderr, "%-36s %14.1f %s\n", "replay.took", took / 1e3, "ms");
+    fprintf(stderr, "%-36s %14.1f %s\n", "replay.frame.mean", c.frame_us.count ? (double)c.frame_us.sum / c.frame_us.count : 0.0, "us");
+    fprintf(stderr, "%-36s %14.1f %s\n", "replay.frame.p99", (double)c.frame_us.Percentile(0.99), "us");
+    fprintf(stderr, "%-36s %14.1f %s\n", "replay.frame.max", (double)c.frame_us.max, "us");
+    fprintf(stderr, "%-36s %14.1f %s\n", "replay.bytes", played ? (double)c.bytes_written / played : 0.0, "B/frame");
+
+    return 0;
+}
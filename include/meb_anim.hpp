@@ -0,0 +1,207 @@
+/**
+ * @file meb_anim.hpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Frame-paced window animation, applying each window's geometry at most once per frame.
+ * @version See Git tags for version information.
+ * @date 2026.10.16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MEB_ANIM_HPP
+#define MEB_ANIM_HPP
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "mebgui.hpp"
+
+class MEBEventLoop;
+
+// Frame rate used unless SetFrameRate(...) is called.
+#define MEB_ANIM_DEFAULT_FPS 60
+
+/**
+ * @brief How an animation progresses over its duration.
+ *
+ */
+enum MEBEasing
+{
+    MEB_EASE_LINEAR,
+    MEB_EASE_IN,     // Starts slowly.
+    MEB_EASE_OUT,    // Ends slowly.
+    MEB_EASE_IN_OUT, // Starts and ends slowly.
+};
+
+/**
+ * @brief Schedules window moves and resizes, applying them once per frame at a fixed frame rate.
+ *
+ * Move(...), MoveTo(...), Resize(...) and ResizeTo(...) only record where a window should end up; any number of them
+ * made between two frames become a single MEBWindow::Place(...) at the next frame. Animate(...) interpolates a
+ * window's position and size towards a target over a duration instead.
+ *
+ * Positions are worked out from the time each frame is actually applied, not advanced a step per frame, so when the
+ * terminal falls behind the frames it could not show are skipped rather than queued, and animations still finish on
+ * time. Once attached to a MEBEventLoop, a timer paces the frames while anything is scheduled and is removed when
+ * everything has settled, so an idle screen is not woken.
+ *
+ * Windows placed by a MEBLayout should not be scheduled here as well. Cancel(...) a window before deleting it.
+ *
+ */
+class MEBAnimator
+{
+public:
+    /**
+     * @brief Creates the animator; constructor.
+     *
+     * @param fps Frames per second to apply changes at.
+     */
+    MEBAnimator(int fps = MEB_ANIM_DEFAULT_FPS);
+
+    /**
+     * @brief Removes the animator's timer; destructor. Windows stay where they were last placed.
+     *
+     */
+    ~MEBAnimator();
+
+    /**
+     * @brief Applies scheduled changes from a timer on the loop. Without a loop, call Tick() once per frame instead.
+     *
+     * @param loop The MEBEventLoop owned by the UI thread.
+     */
+    void Attach(MEBEventLoop *loop);
+
+    /**
+     * @brief Changes the frame rate.
+     *
+     * @param fps Frames per second, from 1 to 1000.
+     */
+    void SetFrameRate(int fps);
+
+    int GetFrameRate() { return fps; };
+
+    /**
+     * @brief Moves a window by some delta-x and delta-y from where it is scheduled to end up, at the next frame.
+     *
+     * @param w The window.
+     * @param dx Change in the X-positional coordinate.
+     * @param dy Change in the Y-positional coordinate.
+     */
+    void Move(MEBWindow *w, int dx, int dy);
+
+    /**
+     * @brief Moves a window to a specific location at the next frame.
+     *
+     * @param w The window.
+     * @param x X-positional coordinate (left-right).
+     * @param y Y-positional coordinate (up-down).
+     */
+    void MoveTo(MEBWindow *w, int x, int y);
+
+    /**
+     * @brief Resizes a window by some delta-width and delta-height from its scheduled size, at the next frame.
+     *
+     * @param w The window.
+     * @param dcols Change in columns.
+     * @param drows Change in rows.
+     */
+    void Resize(MEBWindow *w, int dcols, int drows);
+
+    /**
+     * @brief Resizes a window to a specific size at the next frame.
+     *
+     * @param w The window.
+     * @param cols Columns wide.
+     * @param rows Rows tall.
+     */
+    void ResizeTo(MEBWindow *w, int cols, int rows);
+
+    /**
+     * @brief Moves and resizes a window gradually, from where it is now to a target, replacing any scheduled change.
+     *
+     * @param w The window.
+     * @param to The target position and size; x and y as passed to MEBWindow::MoveTo(...).
+     * @param duration_ms Milliseconds until the target is reached.
+     * @param ease How the window progresses over the duration.
+     */
+    void Animate(MEBWindow *w, const MEBRect &to, int duration_ms, MEBEasing ease = MEB_EASE_LINEAR);
+
+    /**
+     * @brief Drops a window's scheduled changes, leaving it where it was last placed.
+     *
+     * @param w The window.
+     */
+    void Cancel(MEBWindow *w);
+
+    /**
+     * @brief Returns true if a window has changes still to be applied.
+     *
+     * @param w The window.
+     */
+    bool IsScheduled(MEBWindow *w);
+
+    /**
+     * @brief Returns where a window is scheduled to end up, or its current geometry if nothing is scheduled.
+     *
+     * @param w The window.
+     */
+    MEBRect Target(MEBWindow *w);
+
+    /**
+     * @brief Applies scheduled changes if a frame is due; called by the timer once attached.
+     *
+     * @param force Apply them even if a frame is not yet due.
+     * @return int The number of windows moved or resized.
+     */
+    int Tick(bool force = false);
+
+    uint64_t Requested() { return requested; }; // Calls to Move(...), MoveTo(...), Resize(...), ResizeTo(...) and Animate(...).
+    uint64_t Placed() { return placed; };       // Calls made to MEBWindow::Place(...).
+    uint64_t Skipped() { return skipped; };     // Frames not shown because the previous one was late.
+
+private:
+    struct track
+    {
+        MEBWindow *window;
+        MEBRect from;
+        MEBRect to;
+        uint64_t start_us;
+        uint64_t duration_us; // 0 to jump to the target at the next frame.
+        MEBEasing ease;
+    };
+
+    // FOR INTERNAL USE ONLY
+    track *find(MEBWindow *w);
+    void schedule(MEBWindow *w, const MEBRect &to);
+    void arm();
+    void disarm();
+
+    MEBEventLoop *loop;
+    int timer; // -1 while not armed.
+    int fps;
+    uint64_t interval_us;
+    uint64_t last_frame_us; // 0 before the first frame.
+
+    std::vector<track> tracks;
+
+    uint64_t requested;
+    uint64_t placed;
+    uint64_t skipped;
+};
+
+#endif // MEB_ANIM_HPP
@@ -0,0 +1,106 @@
+/**
+ * @file meb_arena.hpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief A string arena with size-class recycling, for per-widget text storage.
+ * @version See Git tags for version information.
+ * @date 2026.10.16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MEB_ARENA_HPP
+#define MEB_ARENA_HPP
+
+#include <stddef.h>
+
+#include <vector>
+
+// Bytes per chunk the arena carves strings from.
+#define MEB_ARENA_CHUNK 65536
+// Strings longer than this are allocated individually.
+#define MEB_ARENA_MAX_CLASS 4096
+
+/**
+ * @brief Stores NUL-terminated strings in large chunks.
+ *
+ * Each string is rounded up to a power-of-two size class, from 16 bytes up to MEB_ARENA_MAX_CLASS. Freed strings go
+ * on a free list for their class and are reused before the arena grows. A workload that keeps replacing strings of
+ * similar lengths therefore reaches a steady state and stops allocating, however long it runs. Not thread-safe.
+ *
+ */
+class MEBArena
+{
+public:
+    /**
+     * @brief Creates an empty arena; constructor.
+     *
+     */
+    MEBArena();
+
+    /**
+     * @brief Frees every chunk and long string, invalidating all strings; destructor.
+     *
+     */
+    ~MEBArena();
+
+    /**
+     * @brief Copies a string into the arena.
+     *
+     * @param str The string; NULL is treated as "".
+     * @return char* The copy, valid until passed to Free(...) or the arena is destroyed.
+     */
+    char *Strdup(const char *str);
+
+    /**
+     * @brief Returns a string to the arena for reuse.
+     *
+     * @param str A string returned by Strdup(...), or NULL.
+     */
+    void Free(char *str);
+
+    /**
+     * @brief Returns the number of bytes held from the system.
+     *
+     */
+    size_t Footprint() { return footprint; };
+
+private:
+    // Each string is preceded by its size class, so Free(...) knows which list it belongs on.
+    struct header
+    {
+        size_t size_class;
+    };
+
+    // Strings too long for a class are allocated individually, linked in front of their header so the destructor finds them.
+    struct large
+    {
+        large *prev;
+        large *next;
+    };
+
+    // FOR INTERNAL USE ONLY
+    static int class_of(size_t bytes);
+
+    std::vector<char *> chunks;
+    large *large_list;
+    char *cursor;
+    size_t remaining;
+    std::vector<std::vector<char *> > free_lists;
+    size_t footprint;
+};
+
+#endif // MEB_ARENA_HPP
@@ -0,0 +1,221 @@
+/**
+ * @file meb_cells.hpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief An in-memory grid of character cells which frames can be built in, snapshotted, diffed and dumped.
+ * @version See Git tags for version information.
+ * @date 2026.10.16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MEB_CELLS_HPP
+#define MEB_CELLS_HPP
+
+#include <ncurses.h>
+#include <menu.h>
+#include <stdio.h>
+
+#include <vector>
+
+#include "mebgui.hpp"
+
+// Line-drawing cells, stored as their VT100 alternate-character-set letters so they mean the same with or without
+// NCURSES initialized. They are translated through acs_map when drawn to a WINDOW.
+#define MEB_CELL_HLINE ('q' | A_ALTCHARSET)
+#define MEB_CELL_VLINE ('x' | A_ALTCHARSET)
+#define MEB_CELL_ULCORNER ('l' | A_ALTCHARSET)
+#define MEB_CELL_URCORNER ('k' | A_ALTCHARSET)
+#define MEB_CELL_LLCORNER ('m' | A_ALTCHARSET)
+#define MEB_CELL_LRCORNER ('j' | A_ALTCHARSET)
+
+/**
+ * @brief A grid of character cells, each a chtype holding the character, its attributes and its color pair.
+ *
+ * The grid is plain memory: drawing into it makes no NCURSES calls and no terminal round-trips, so a frame can be
+ * built without a terminal, or on a worker thread and handed to the UI thread to Draw(...). A grid is not safe to
+ * use from two threads at once. Everything drawn is clipped to the grid.
+ *
+ */
+class MEBCellBuffer
+{
+public:
+    /**
+     * @brief Creates a grid of blank cells; constructor.
+     *
+     * @param cols Columns wide.
+     * @param rows Rows tall.
+     */
+    MEBCellBuffer(int cols = 0, int rows = 0);
+
+    /**
+     * @brief Resizes the grid, keeping the cells which still fit. New cells are blank.
+     *
+     * @param cols Columns wide.
+     * @param rows Rows tall.
+     */
+    void Resize(int cols, int rows);
+
+    /**
+     * @brief Sets every cell.
+     *
+     * @param blank (Optional) The cell to fill with.
+     */
+    void Clear(chtype blank = ' ');
+
+    /**
+     * @brief Sets a rectangle of cells.
+     *
+     */
+    void Fill(int x, int y, int cols, int rows, chtype ch);
+
+    /**
+     * @brief Moves a band of whole rows up or down within itself, as a terminal scrolls its scroll region. Rows exposed are blank.
+     *
+     * @param top The band's first row.
+     * @param bottom The band's last row.
+     * @param n Rows to move up; negative moves them down.
+     * @param blank (Optional) The cell to fill exposed rows with.
+     */
+    void ScrollRows(int top, int bottom, int n, chtype blank = ' ');
+
+    /**
+     * @brief Sets one cell.
+     *
+     */
+    void Put(int x, int y, chtype ch)
+    {
+        if (x >= 0 && x < cols_ && y >= 0 && y < rows_)
+            cells[y * cols_ + x] = ch;
+    };
+
+    /**
+     * @brief Returns one cell, or a blank outside the grid.
+     *
+     */
+    chtype Get(int x, int y) const { return (x >= 0 && x < cols_ && y >= 0 && y < rows_) ? cells[y * cols_ + x] : ' '; };
+
+    /**
+     * @brief Writes text along one row. Control characters are shown as '?'.
+     *
+     * @param x X-positional coordinate (left-right).
+     * @param y Y-positional coordinate (up-down).
+     * @param text The text.
+     * @param attr (Optional) Attributes and color pair applied to every character.
+     * @return int The column after the last character written.
+     */
+    int Print(int x, int y, const char *text, attr_t attr = A_NORMAL);
+
+    /**
+     * @brief Formats text and writes it as Print(...) does.
+     *
+     */
+    int Printf(int x, int y, attr_t attr, const char *fmt, ...) __attribute__((format(printf, 5, 6)));
+
+    void HLine(int x, int y, int cols, chtype ch = MEB_CELL_HLINE);
+    void VLine(int x, int y, int rows, chtype ch = MEB_CELL_VLINE);
+
+    /**
+     * @brief Draws a border just inside the given rectangle.
+     *
+     */
+    void Box(int x, int y, int cols, int rows);
+
+    /**
+     * @brief Copies another grid into this one.
+     *
+     * @param src The grid to copy.
+     * @param x Where src's left column lands.
+     * @param y Where src's top row lands.
+     */
+    void Blit(const MEBCellBuffer &src, int x, int y);
+
+    /**
+     * @brief Copies the cells of an NCURSES window into this grid. No output is made, and the window's cursor is left where it was.
+     *
+     * @param w The window.
+     * @param x Where the window's left column lands.
+     * @param y Where the window's top row lands.
+     */
+    void Capture(WINDOW *w, int x, int y);
+
+    /**
+     * @brief Stages the grid into an NCURSES window, for MEBScreen to output with the next frame.
+     *
+     * @param w The window.
+     * @param x The window relative x-coordinate of the grid's left column.
+     * @param y The window relative y-coordinate of the grid's top row.
+     * @param prev (Optional) The grid last drawn at the same place; only the cells which differ from it are written.
+     */
+    void Draw(WINDOW *w, int x, int y, const MEBCellBuffer *prev = nullptr) const;
+
+    /**
+     * @brief Finds the span of one row that differs from another grid of the same size. Rows are compared a vector register at a time where SSE2 is available.
+     *
+     * @param prev The other grid.
+     * @param row The row to compare.
+     * @param lo Set to the first differing column.
+     * @param hi Set to the last differing column.
+     * @return true If any cell of the row differs.
+     */
+    bool DiffRow(const MEBCellBuffer &prev, int row, int *lo, int *hi) const;
+
+    /**
+     * @brief Lists the differing span of every row that differs from another grid, one single-row rectangle each.
+     *
+     * A grid of another size differs everywhere.
+     *
+     * @param prev The other grid.
+     * @param spans Replaced with the spans.
+     * @return int The number of spans.
+     */
+    int Diff(const MEBCellBuffer &prev, std::vector<MEBRect> &spans) const;
+
+    /**
+     * @brief Writes the grid as text, one line per row, for golden-image tests.
+     *
+     * Line-drawing cells are written as '-', '|' and '+'. With attributes, each row is followed by a tab and one code
+     * per cell: '.' for none, the first of 'R'everse, 'B'old, 'U'nderline, 'S'tandout, 'D'im, 'I'nvisible or
+     * 'K' (blink) that applies, or otherwise the color pair as a digit or letter.
+     *
+     * @param fp The stream.
+     * @param attrs (Optional) True to include attributes.
+     */
+    void Dump(FILE *fp, bool attrs = false) const;
+
+    /**
+     * @brief Exchanges the contents of two grids without copying any cells.
+     *
+     */
+    void Swap(MEBCellBuffer &other);
+
+    bool operator==(const MEBCellBuffer &other) const;
+    bool operator!=(const MEBCellBuffer &other) const { return !(*this == other); };
+
+    int Cols() const { return cols_; };
+    int Rows() const { return rows_; };
+    const chtype *Row(int y) const { return &cells[y * cols_]; };
+
+private:
+    // FOR INTERNAL USE ONLY
+    bool clip(int *x, int *y, int *cols, int *rows) const;
+
+    int cols_;
+    int rows_;
+    std::vector<chtype> cells; // Row-major.
+};
+
+#endif // MEB_CELLS_HPP
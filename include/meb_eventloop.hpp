@@ -0,0 +1,187 @@
+/**
+ * @file meb_eventloop.hpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief An epoll-driven event loop for mebgui programs.
+ * @version See Git tags for version information.
+ * @date 2026.10.16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MEB_EVENTLOOP_HPP
+#define MEB_EVENTLOOP_HPP
+
+#include <signal.h>
+
+#include <atomic>
+#include <functional>
+#include <map>
+
+/**
+ * @brief An event loop which sleeps in epoll_wait(...) until there is something to do.
+ *
+ * Keyboard input is read from stdin, SIGWINCH / SIGINT / SIGTERM arrive through a signalfd, timers are timerfds and
+ * Wakeup() signals an eventfd. Every batch of events is handled inside one MEBScreen frame, so each wake-up produces
+ * at most one physical update.
+ *
+ * The constructor blocks SIGWINCH, SIGINT and SIGTERM in the calling thread. Construct the loop after ncurses_init(...)
+ * and before spawning any threads, so that they inherit the blocked mask.
+ *
+ */
+class MEBEventLoop
+{
+public:
+    /**
+     * @brief Creates the loop; constructor.
+     *
+     */
+    MEBEventLoop();
+
+    /**
+     * @brief Closes all descriptors and restores the signal mask; destructor.
+     *
+     */
+    ~MEBEventLoop();
+
+    /**
+     * @brief Sets the callback for keypresses, as returned by wgetch(...). KEY_RESIZE is delivered after a resize.
+     *
+     * @param cb The callback.
+     */
+    void OnKey(std::function<void(int)> cb);
+
+    /**
+     * @brief Sets the callback for terminal resizes. The NCURSES screen has already been resized when it is called.
+     *
+     * @param cb The callback, passed the new width and height.
+     */
+    void OnResize(std::function<void(int, int)> cb);
+
+    /**
+     * @brief Sets the callback for SIGINT and SIGTERM. By default the loop stops.
+     *
+     * @param cb The callback, passed the signal number.
+     */
+    void OnQuit(std::function<void(int)> cb);
+
+    /**
+     * @brief Sets the callback run on the loop's thread after every Wakeup().
+     *
+     * @param cb The callback.
+     */
+    void OnWakeup(std::function<void()> cb);
+
+    /**
+     * @brief Adds a timer.
+     *
+     * @param interval_ms Milliseconds until the timer fires, and between firings if repeating.
+     * @param cb The callback.
+     * @param repeat False for a one-shot timer, which is removed after firing.
+     * @return int Timer ID, or -1 on error.
+     */
+    int AddTimer(int interval_ms, std::function<void()> cb, bool repeat = true);
+
+    /**
+     * @brief Removes a timer.
+     *
+     * @param id Timer ID returned by AddTimer(...).
+     */
+    void RemoveTimer(int id);
+
+    /**
+     * @brief Watches an arbitrary file descriptor for readability.
+     *
+     * @param fd The descriptor; not closed by the loop.
+     * @param cb The callback, passed the descriptor.
+     * @return int 0 on success, -1 on error.
+     */
+    int Watch(int fd, std::function<void(int)> cb);
+
+    /**
+     * @brief Stops watching a file descriptor.
+     *
+     * @param fd The descriptor.
+     */
+    void Unwatch(int fd);
+
+    /**
+     * @brief Wakes the loop from any thread.
+     *
+     */
+    void Wakeup();
+
+    /**
+     * @brief Runs until Stop() is called.
+     *
+     */
+    void Run();
+
+    /**
+     * @brief Waits for and handles one batch of events.
+     *
+     * @param timeout_ms Maximum wait in milliseconds, or -1 to wait indefinitely.
+     * @return int Number of events handled, or -1 on error.
+     */
+    int RunOnce(int timeout_ms = -1);
+
+    /**
+     * @brief Makes Run() return; safe to call from any thread.
+     *
+     */
+    void Stop();
+
+    bool IsRunning() { return running; };
+
+private:
+    enum source_type
+    {
+        SRC_INPUT,
+        SRC_SIGNAL,
+        SRC_WAKEUP,
+        SRC_TIMER,
+        SRC_FD,
+    };
+
+    struct source
+    {
+        source_type type;
+        bool repeat;
+        std::function<void()> timer_cb;
+        std::function<void(int)> fd_cb;
+    };
+
+    // FOR INTERNAL USE ONLY
+    void add_source(int fd, source_type type);
+    void handle_input();
+    void handle_signal();
+
+    int epfd;
+    int sigfd;
+    int evfd;
+    std::atomic<bool> running;
+
+    sigset_t old_mask;
+
+    std::map<int, source> sources;
+
+    std::function<void(int)> key_cb;
+    std::function<void(int, int)> resize_cb;
+    std::function<void(int)> quit_cb;
+    std::function<void()> wakeup_cb;
+};
+
+#endif // MEB_EVENTLOOP_HPP
@@ -0,0 +1,216 @@
+/**
+ * @file meb_input.hpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief A single-line text entry field fed from the event loop's keystrokes.
+ * @version See Git tags for version information.
+ * @date 2026.10.16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MEB_INPUT_HPP
+#define MEB_INPUT_HPP
+
+#include <stdio.h>
+
+#include <deque>
+#include <functional>
+#include <string>
+
+#include "mebgui.hpp"
+
+#define MEB_INPUT_DEFAULT_MAX 255
+#define MEB_INPUT_DEFAULT_HISTORY 32
+
+/**
+ * @brief A line of editable text inside a MEBWindow, in place of the blocking input(...).
+ *
+ * Nothing waits for input: pass every key to Update(...) and the field edits its own buffer, so the rest of the
+ * screen keeps updating while the user types. Enter submits the line to the OnSubmit(...) callback and adds it to a
+ * bounded history, recalled with up / down. Scan(...), ParseInt(...) and ParseDouble(...) turn the submitted line
+ * into typed values.
+ *
+ * Keys: left / right, home / end (or Ctrl+A / Ctrl+E), backspace, delete, Ctrl+U and Ctrl+K (delete to the start or
+ * end of the line), Ctrl+W (delete the previous word), up / down (history), Enter (submit) and Escape (cancel).
+ *
+ * Render() redraws the field only in frames where its text, cursor or focus changed. Text wider than the field is
+ * scrolled to keep the cursor in view.
+ *
+ */
+class MEBInputField : public MEBWidget
+{
+public:
+    /**
+     * @brief Spawns an input field, without focus; constructor.
+     *
+     * @param w Parent MEBWindow.
+     * @param x Parent window relative x-axis offset.
+     * @param y Parent window relative y-axis offset.
+     * @param cols Width, including the prompt.
+     * @param prompt (Optional) Text shown before the line.
+     * @param max_len (Optional) Most characters the line may hold.
+     * @param history (Optional) Number of submitted lines kept for recall.
+     */
+    MEBInputField(MEBWindow *w, int x, int y, int cols, const char *prompt = nullptr, int max_len = MEB_INPUT_DEFAULT_MAX, int history = MEB_INPUT_DEFAULT_HISTORY);
+
+    /**
+     * @brief Destructor.
+     *
+     */
+    ~MEBInputField();
+
+    /**
+     * @brief Sets the callback for Enter. The line has already been added to the history and cleared.
+     *
+     * @param cb The callback, passed the submitted line; also available from GetSubmitted().
+     */
+    void OnSubmit(std::function<void(const char *)> cb);
+
+    /**
+     * @brief Sets the callback for Escape. The line has already been cleared and the field unfocused.
+     *
+     * @param cb The callback.
+     */
+    void OnCancel(std::function<void()> cb);
+
+    /**
+     * @brief Gives or takes away the keyboard. Update(...) ignores keys while the field is not focused.
+     *
+     * @param focus True to focus.
+     */
+    void Focus(bool focus);
+
+    bool Focused() { return focused; };
+
+    /**
+     * @brief Edits the line with a key.
+     *
+     * @param in The user's input, retrieved via wgetch(...).
+     * @return true If the field is focused and the key was used.
+     */
+    bool Update(int in);
+
+    /**
+     * @brief Draws the field if it changed since the last frame; called by MEBScreen once per frame.
+     *
+     */
+    void Render();
+
+    const char *Name() { return "input"; };
+
+    /**
+     * @brief Replaces the line, putting the cursor at its end.
+     *
+     * @param text The text, truncated to the maximum length.
+     */
+    void SetText(const char *text);
+
+    /**
+     * @brief Empties the line.
+     *
+     */
+    void Clear() { SetText(""); };
+
+    const char *GetText() { return text.c_str(); };
+    const char *GetSubmitted() { return submitted.c_str(); };
+    int GetCursor() { return cursor; };
+    const std::deque<std::string> &GetHistory() { return history; };
+
+    /**
+     * @brief Parses the last submitted line with sscanf(...).
+     *
+     * @param fmt Formatted input, as for scanf(...).
+     * @param ... Formatted input's arguments.
+     * @return int The number of fields converted, or EOF if the line was empty.
+     */
+    template <typename... Args>
+    int Scan(const char *fmt, Args... args)
+    {
+        return sscanf(submitted.c_str(), fmt, args...);
+    }
+
+    /**
+     * @brief Parses the last submitted line as a whole integer, allowing surrounding spaces.
+     *
+     * @param out The value; unchanged on failure.
+     * @param base The base, as for strtol(...); 0 accepts 0x and 0 prefixes.
+     * @return true If the line held exactly one integer, in range.
+     */
+    bool ParseInt(long *out, int base = 10);
+
+    /**
+     * @brief Parses the last submitted line as a whole floating-point number, allowing surrounding spaces.
+     *
+     * @param out The value; unchanged on failure.
+     * @return true If the line held exactly one number, in range.
+     */
+    bool ParseDouble(double *out);
+
+    /**
+     * @brief Moves the field some delta-position.
+     *
+     */
+    void Move(int dx, int dy);
+
+    /**
+     * @brief Recreates the field's sub-window and redraws it.
+     *
+     */
+    void Refresh();
+
+    /**
+     * @brief Deletes the sub-window if it was made from w, which its MEBWindow is about to delete; another is made from the window's next NCURSES window.
+     *
+     */
+    void Release(WINDOW *w);
+
+    MEBWindow *GetParent() { return parent; };
+
+private:
+    // FOR INTERNAL USE ONLY
+    void insert(char c);
+    void erase(int from, int to);
+    void recall(int delta);
+    void submit();
+    void changed();
+
+    int x;
+    int y;
+    int cols;
+    MEBWindow *parent;
+    WINDOW *posted_win; // The parent's NCURSES window when the sub-window was made.
+    WINDOW *sub;
+
+    std::string prompt;
+    std::string text;
+    std::string submitted;
+    int max_len;
+    int cursor; // Index into text at which characters are inserted.
+    int scroll; // Index into text of the first character shown.
+    bool focused;
+    bool redraw;
+
+    std::deque<std::string> history; // Oldest first.
+    int history_max;
+    int recalled;        // Index into history being shown, or -1 for the line being edited.
+    std::string pending; // The line being edited, while the history is shown.
+
+    std::function<void(const char *)> submit_cb;
+    std::function<void()> cancel_cb;
+};
+
+#endif // MEB_INPUT_HPP
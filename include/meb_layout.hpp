@@ -0,0 +1,182 @@
+/**
+ * @file meb_layout.hpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Constraint layout for MEBWindows, reapplied when the terminal is resized.
+ * @version See Git tags for version information.
+ * @date 2026.10.16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MEB_LAYOUT_HPP
+#define MEB_LAYOUT_HPP
+
+#include <limits.h>
+
+#include <vector>
+
+#include "mebgui.hpp"
+
+/**
+ * @brief How a layout node lays out its children.
+ *
+ */
+enum MEBLayoutDirection
+{
+    MEB_LAYOUT_ROW,    // Left to right.
+    MEB_LAYOUT_COLUMN, // Top to bottom.
+};
+
+/**
+ * @brief The size of a layout node along its parent's direction. Across it, a node takes the parent's full extent.
+ *
+ */
+struct MEBConstraint
+{
+    int fixed;     // Cells, if not negative.
+    int percent;   // Percentage of the parent, if fixed is negative and this is not.
+    int flex;      // Otherwise, a share of what is left over, by weight.
+    int min_cells; // Never smaller than this while there is room.
+    int max_cells; // Never larger than this.
+
+    static MEBConstraint Fixed(int cells) { MEBConstraint c = {cells, -1, 0, 0, INT_MAX}; return c; };
+    static MEBConstraint Percent(int percent) { MEBConstraint c = {-1, percent, 0, 0, INT_MAX}; return c; };
+    static MEBConstraint Flex(int weight = 1) { MEBConstraint c = {-1, -1, weight, 0, INT_MAX}; return c; };
+
+    MEBConstraint Min(int cells) const { MEBConstraint c = *this; c.min_cells = cells; return c; };
+    MEBConstraint Max(int cells) const { MEBConstraint c = *this; c.max_cells = cells; return c; };
+
+    bool operator==(const MEBConstraint &o) const { return fixed == o.fixed && percent == o.percent && flex == o.flex && min_cells == o.min_cells && max_cells == o.max_cells; };
+};
+
+/**
+ * @brief A node of a layout tree: a split holding other nodes, a MEBWindow, or empty space.
+ *
+ * Each node caches the rectangle it was last given. Apply(...) only redistributes the children of splits whose
+ * rectangle or children's constraints changed, descends into other splits only where something beneath them changed,
+ * and only moves or resizes windows whose geometry actually differs, each with a single MEBWindow::Place(...).
+ *
+ * Give a root node to MEBScreen::SetLayout(...) to have it applied to the whole screen at the start of every frame in
+ * which the terminal was resized or a constraint changed, however many resizes arrived in between. Windows in a layout
+ * should have no parent window.
+ *
+ */
+class MEBLayout
+{
+public:
+    /**
+     * @brief Creates a root split; constructor.
+     *
+     * @param dir How the children are laid out.
+     */
+    MEBLayout(MEBLayoutDirection dir);
+
+    /**
+     * @brief Deletes the node and every node beneath it; destructor. Windows are not deleted.
+     *
+     */
+    ~MEBLayout();
+
+    /**
+     * @brief Adds a split beneath this one.
+     *
+     * @param dir How the new split lays out its children.
+     * @param c Its size.
+     * @return MEBLayout* The new node, owned by this one.
+     */
+    MEBLayout *AddSplit(MEBLayoutDirection dir, MEBConstraint c);
+
+    /**
+     * @brief Adds a window beneath this split.
+     *
+     * @param w The window, which is moved and resized to fit.
+     * @param c Its size.
+     * @return MEBLayout* The new node, owned by this one.
+     */
+    MEBLayout *AddWindow(MEBWindow *w, MEBConstraint c);
+
+    /**
+     * @brief Adds empty space beneath this split.
+     *
+     * @param c Its size.
+     * @return MEBLayout* The new node, owned by this one.
+     */
+    MEBLayout *AddSpace(MEBConstraint c);
+
+    /**
+     * @brief Removes and deletes a node beneath this split.
+     *
+     * @param child The node.
+     */
+    void Remove(MEBLayout *child);
+
+    /**
+     * @brief Changes the node's size. Its siblings are laid out again with the next Apply(...).
+     *
+     * @param c The new size.
+     */
+    void SetConstraint(MEBConstraint c);
+
+    /**
+     * @brief Sets the cells left between the children of this split.
+     *
+     * @param cells The gap.
+     */
+    void SetGap(int cells);
+
+    /**
+     * @brief Lays the tree out within a rectangle, doing only the work that changed since the last call.
+     *
+     * @param r The rectangle, in screen coordinates.
+     * @return int The number of windows moved or resized.
+     */
+    int Apply(const MEBRect &r);
+
+    /**
+     * @brief Returns true if something beneath this node changed since it was last applied.
+     *
+     */
+    bool NeedsApply() { return dirty || child_dirty; };
+
+    const MEBRect &GetRect() { return rect; };
+    const MEBConstraint &GetConstraint() { return constraint; };
+    const std::vector<MEBLayout *> &GetChildren() { return children; };
+    MEBWindow *GetWindow() { return window; };
+
+private:
+    MEBLayout(MEBLayout *parent, MEBLayoutDirection dir, MEBWindow *w, MEBConstraint c);
+
+    // FOR INTERNAL USE ONLY
+    MEBLayout *add(MEBLayout *child);
+    void mark_dirty();
+    void distribute(int length, std::vector<int> &sizes);
+
+    MEBLayout *parent;
+    MEBLayoutDirection dir;
+    MEBWindow *window; // Leaf nodes only; nullptr for splits and space.
+    bool is_split;
+    MEBConstraint constraint;
+    int gap;
+    std::vector<MEBLayout *> children;
+
+    MEBRect rect;     // As last applied.
+    bool applied;     // rect is valid.
+    bool dirty;       // The children must be redistributed.
+    bool child_dirty; // Some node beneath must be redistributed.
+};
+
+#endif // MEB_LAYOUT_HPP
@@ -0,0 +1,183 @@
+/**
+ * @file meb_log.hpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief A scrolling log pane fed from any thread through a lock-free ring buffer.
+ * @version See Git tags for version information.
+ * @date 2026.10.16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MEB_LOG_HPP
+#define MEB_LOG_HPP
+
+#include <stdint.h>
+
+#include <atomic>
+
+#include "mebgui.hpp"
+
+class MEBEventLoop;
+
+// Bytes kept of each line, including the terminator; longer lines are truncated.
+#define MEB_LOG_LINE_MAX 256
+#define MEB_LOG_DEFAULT_SCROLLBACK 10000
+
+/**
+ * @brief A log pane inside a MEBWindow.
+ *
+ * Lines are stored in a fixed ring of scrollback slots allocated up front, so memory use never grows. Any thread may
+ * Append(...) without locking: each line claims a slot with one atomic increment and publishes it through a per-slot
+ * sequence number, which the UI thread checks to skip slots caught mid-write. Once the ring is full the oldest lines
+ * are overwritten.
+ *
+ * Nothing is drawn on append. Render() runs once per frame and draws only what changed: while following the tail,
+ * the pane is scrolled by the number of new lines and only those are drawn, however many arrived.
+ *
+ */
+class MEBLogWindow : public MEBWidget
+{
+public:
+    /**
+     * @brief Spawns a log pane; constructor.
+     *
+     * @param w Parent MEBWindow.
+     * @param x Parent window relative x-axis offset.
+     * @param y Parent window relative y-axis offset.
+     * @param cols Width.
+     * @param rows Height.
+     * @param scrollback (Optional) Number of lines kept.
+     */
+    MEBLogWindow(MEBWindow *w, int x, int y, int cols, int rows, int scrollback = MEB_LOG_DEFAULT_SCROLLBACK);
+
+    /**
+     * @brief Destructor. No thread may be appending.
+     *
+     */
+    ~MEBLogWindow();
+
+    /**
+     * @brief Wakes the loop when lines arrive, so they are drawn without waiting for other activity.
+     *
+     * @param loop The MEBEventLoop owned by the UI thread. Attach before any thread starts appending.
+     */
+    void Attach(MEBEventLoop *loop);
+
+    /**
+     * @brief Appends text, one line per newline-separated part. Safe to call from any thread.
+     *
+     * @param text The text. Tabs are expanded and other control characters are shown as '?'.
+     */
+    void Append(const char *text);
+
+    /**
+     * @brief Formats text and appends it. Safe to call from any thread.
+     *
+     */
+    void Printf(const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+
+    /**
+     * @brief Draws whatever changed since the last frame; called by MEBScreen once per frame.
+     *
+     */
+    void Render();
+
+    const char *Name() { return "log"; };
+
+    /**
+     * @brief Handles up / down, page up / page down and home / end scrolling. End resumes following the tail.
+     *
+     * @param in The user's input, retrieved via wgetch(...).
+     * @return true If the key was used.
+     */
+    bool Update(int in);
+
+    /**
+     * @brief Scrolls the view, which then stays put as lines arrive. Scrolling to the tail follows it again.
+     *
+     * @param delta Lines to scroll; negative is back in time.
+     */
+    void Scroll(int delta);
+
+    /**
+     * @brief Jumps to, and follows, the tail.
+     *
+     */
+    void Follow();
+
+    /**
+     * @brief Moves the pane some delta-position.
+     *
+     */
+    void Move(int dx, int dy);
+
+    /**
+     * @brief Recreates the pane's sub-window and redraws it.
+     *
+     */
+    void Refresh();
+
+    /**
+     * @brief Deletes the sub-window if it was made from w, which its MEBWindow is about to delete; another is made from the window's next NCURSES window.
+     *
+     */
+    void Release(WINDOW *w);
+
+    bool Following() { return follow; };
+    uint64_t Count() { return head.load(std::memory_order_relaxed); }; // Lines ever appended.
+    uint64_t Dropped() { return dropped.load(std::memory_order_relaxed); };
+    int Scrollback() { return capacity; };
+    MEBWindow *GetParent() { return parent; };
+
+private:
+    struct slot
+    {
+        std::atomic<uint64_t> seq; // 2 * line + 2 once the line is published; odd while being written.
+        uint16_t len;
+        char text[MEB_LOG_LINE_MAX];
+    };
+
+    // FOR INTERNAL USE ONLY
+    void append_line(const char *text, size_t len);
+    bool read_line(uint64_t line, char *out, int *len);
+    void draw_row(int r, uint64_t line);
+
+    int x;
+    int y;
+    int cols;
+    int rows;
+    MEBWindow *parent;
+    WINDOW *posted_win; // The parent's NCURSES window when the sub-window was made.
+    WINDOW *sub;
+
+    slot *slots;
+    int capacity;
+    std::atomic<uint64_t> head; // Number of the next line to be appended.
+    std::atomic<uint64_t> dropped;
+    std::atomic<bool> pending;  // A wake-up has been sent since the last Render().
+    MEBEventLoop *loop;
+
+    // UI thread only.
+    bool follow;
+    uint64_t view_bottom; // One past the last line shown, when not following.
+    uint64_t drawn_top;   // Lines [drawn_top, drawn_bottom) are on screen, from the first row down.
+    uint64_t drawn_bottom;
+    bool redraw;
+    char line[MEB_LOG_LINE_MAX];
+};
+
+#endif // MEB_LOG_HPP
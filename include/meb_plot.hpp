@@ -0,0 +1,203 @@
+/**
+ * @file meb_plot.hpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief A scrolling time-series plot, decimating samples into per-column minimum / maximum buckets as they arrive.
+ * @version See Git tags for version information.
+ * @date 2026.10.16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MEB_PLOT_HPP
+#define MEB_PLOT_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include "mebgui.hpp"
+
+class MEBEventLoop;
+
+// Samples kept for re-bucketing when the samples per column change.
+#define MEB_PLOT_DEFAULT_CAPACITY (1 << 20)
+// Distinct heights within one row of the plot, drawn with the terminal's scan-line characters.
+#define MEB_PLOT_LEVELS_PER_ROW 4
+
+/**
+ * @brief A plot of the most recent samples of a series inside a MEBWindow; a sparkline when one row tall.
+ *
+ * Each column shows a bucket of consecutive samples as a bar from its minimum to its maximum, so no spike is lost
+ * however many samples a column covers. Buckets are kept up to date as samples arrive: a batch is folded into the
+ * newest bucket four samples at a time with SSE2 where available, and only as many buckets as there are columns are kept. Drawing
+ * therefore costs the same whatever the sample rate. Heights are drawn with the scan-line characters of the terminal's
+ * line-drawing set, four to a row.
+ *
+ * The last MEB_PLOT_DEFAULT_CAPACITY (or as chosen) samples are also kept as they are, so the buckets can be rebuilt
+ * when SetSamplesPerColumn(...) zooms in or out.
+ *
+ * Push(...) may be called from any thread; each call takes a lock, so push samples in batches. NaN samples are not
+ * supported.
+ *
+ */
+class MEBPlot : public MEBWidget
+{
+public:
+    /**
+     * @brief Spawns an empty plot; constructor.
+     *
+     * @param w Parent MEBWindow.
+     * @param x Parent window relative x-axis offset.
+     * @param y Parent window relative y-axis offset.
+     * @param cols Width, which is also the number of buckets shown.
+     * @param rows Height.
+     * @param samples_per_col (Optional) Samples decimated into each column.
+     * @param capacity (Optional) Samples kept for re-bucketing.
+     */
+    MEBPlot(MEBWindow *w, int x, int y, int cols, int rows, int samples_per_col = 1, int capacity = MEB_PLOT_DEFAULT_CAPACITY);
+
+    /**
+     * @brief Destructor. No thread may be pushing.
+     *
+     */
+    ~MEBPlot();
+
+    /**
+     * @brief Wakes the loop when samples arrive, so they are drawn without waiting for other activity.
+     *
+     * @param loop The MEBEventLoop owned by the UI thread. Attach before any thread starts pushing.
+     */
+    void Attach(MEBEventLoop *loop);
+
+    /**
+     * @brief Appends samples. Safe to call from any thread.
+     *
+     * @param samples The samples, oldest first.
+     * @param n Number of samples.
+     */
+    void Push(const float *samples, size_t n);
+
+    /**
+     * @brief Appends one sample. Safe to call from any thread.
+     *
+     */
+    void Push(float sample) { Push(&sample, 1); };
+
+    /**
+     * @brief Changes how many samples each column covers, rebuilding the buckets from the samples kept.
+     *
+     * @param n Samples per column, at least 1.
+     */
+    void SetSamplesPerColumn(int n);
+
+    /**
+     * @brief Fixes the vertical range. Samples outside it are drawn at the nearest edge.
+     *
+     * @param lo The value at the bottom of the plot.
+     * @param hi The value at the top.
+     */
+    void SetRange(float lo, float hi);
+
+    /**
+     * @brief Fits the vertical range to the samples shown, every frame. The default.
+     *
+     */
+    void SetAutoRange();
+
+    /**
+     * @brief Draws the buckets if samples arrived or the plot changed since the last frame; called by MEBScreen once per frame.
+     *
+     */
+    void Render();
+
+    const char *Name() { return "plot"; };
+
+    /**
+     * @brief Moves the plot some delta-position.
+     *
+     */
+    void Move(int dx, int dy);
+
+    /**
+     * @brief Recreates the plot's sub-window and redraws it.
+     *
+     */
+    void Refresh();
+
+    /**
+     * @brief Deletes the sub-window if it was made from w, which its MEBWindow is about to delete; another is made from the window's next NCURSES window.
+     *
+     */
+    void Release(WINDOW *w);
+
+    /**
+     * @brief Returns the most recent sample, or 0 if there is none.
+     *
+     */
+    float Last();
+
+    int GetSamplesPerColumn() { return spc; };
+    uint64_t Count() { return total.load(std::memory_order_relaxed); }; // Samples ever pushed.
+    MEBWindow *GetParent() { return parent; };
+
+private:
+    struct bucket
+    {
+        float lo;
+        float hi;
+        float last;
+        uint32_t count;
+    };
+
+    // FOR INTERNAL USE ONLY
+    void fold(const float *samples, size_t n);
+    void reduce(uint64_t from, uint64_t to, bucket &b);
+    void rebucket();
+    void draw_column(int c, const bucket &b, float lo, float hi);
+
+    int x;
+    int y;
+    int cols;
+    int rows;
+    MEBWindow *parent;
+    WINDOW *posted_win; // The parent's NCURSES window when the sub-window was made.
+    WINDOW *sub;
+    MEBEventLoop *loop;
+
+    // Shared with pushing threads under lock.
+    std::mutex lock;
+    std::vector<float> ring; // The last samples pushed, as they are; sample i is at i % capacity.
+    std::vector<bucket> buckets; // The last closed buckets, a ring of cols.
+    size_t bucket_at;            // Where the next closed bucket goes.
+    size_t n_buckets;            // Closed buckets held, up to cols.
+    bucket open;                 // The newest bucket, still filling.
+    int spc;
+    std::atomic<uint64_t> total;
+    std::atomic<bool> pending; // Samples arrived since the last Render().
+
+    // UI thread only.
+    bool auto_range;
+    float range_lo;
+    float range_hi;
+    bool redraw;
+    std::vector<bucket> shown; // Copied out of the ring to draw, oldest first.
+};
+
+#endif // MEB_PLOT_HPP
@@ -7,6 +7,10 @@
  *
  * With revisions by Sunip K. Mukherjee (sunipkmukherjee@gmail.com).
  *
+ * Define MEB_PRINT_ASYNC before including this file, and link src/meb_print.cpp, to have the macros below hand their
+ * output to a background writer instead of printing and flushing on the calling thread. Output may then also be
+ * routed away from stdout / stderr, e.g. into a MEBLogWindow, with meb_print_set_sink(...).
+ *
  * @copyright Copyright (c) 2021
  *
  */
@@ -30,6 +34,62 @@
 #define MEB_DBGLVL MEB_DBG_ALL
 #endif // MEB_DBGLVL
 
+#ifdef MEB_PRINT_ASYNC
+
+#include <stddef.h>
+
+#define MEB_PRINT_STDOUT 0
+#define MEB_PRINT_STDERR 1
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief Formats a message into the calling thread's buffer for the background writer. Never blocks on I/O.
+     *
+     * @param stream MEB_PRINT_STDOUT or MEB_PRINT_STDERR.
+     * @return int The number of characters formatted, as printf(...).
+     */
+    int meb_print_async(int stream, const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+    /**
+     * @brief Blocks until everything printed so far has been written.
+     *
+     */
+    void meb_print_flush(void);
+
+    /**
+     * @brief Sends output, one line at a time with colors stripped, to a callback instead of stdout / stderr.
+     *
+     * The callback is run on the background writer's thread. Everything printed before the call goes to the old callback,
+     * which is neither running nor about to run once this returns, so its context may then be freed. Not to be called
+     * from a callback.
+     *
+     * @param sink The callback, or NULL to go back to stdout / stderr.
+     * @param ctx Passed to the callback.
+     */
+    void meb_print_set_sink(void (*sink)(void *ctx, int stream, const char *line), void *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#define MEB_PRINT_OUT(format, ...) meb_print_async(MEB_PRINT_STDOUT, format, ##__VA_ARGS__)
+#define MEB_PRINT_ERR(format, ...) meb_print_async(MEB_PRINT_STDERR, format, ##__VA_ARGS__)
+#define MEB_PRINT_FLUSH_OUT()
+#define MEB_PRINT_FLUSH_ERR()
+
+#else // MEB_PRINT_ASYNC
+
+#define MEB_PRINT_OUT(format, ...) printf(format, ##__VA_ARGS__)
+#define MEB_PRINT_ERR(format, ...) fprintf(stderr, format, ##__VA_ARGS__)
+#define MEB_PRINT_FLUSH_OUT() fflush(stdout)
+#define MEB_PRINT_FLUSH_ERR() fflush(stderr)
+
+#endif // MEB_PRINT_ASYNC
+
 #if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
 #define OS_Windows
 #define TERMINATOR
@@ -86,8 +146,8 @@
     {                                                                                                             \
         if (MEB_DBGLVL & MEB_DBG_DBPRINT)                                                                         \
         {                                                                                                         \
-            fprintf(stderr, "[%s:%d | %s] " format TERMINATOR "\n", __FILE__, __LINE__, __func__, ##__VA_ARGS__); \
-            fflush(stderr);                                                                                       \
+            MEB_PRINT_ERR("[%s:%d | %s] " format TERMINATOR "\n", __FILE__, __LINE__, __func__, ##__VA_ARGS__);   \
+            MEB_PRINT_FLUSH_ERR();                                                                                \
         }                                                                                                         \
     }
 #endif // dbprintlf
@@ -97,8 +157,8 @@
     {                                                                                                        \
         if (MEB_DBGLVL & MEB_DBG_DBPRINT)                                                                    \
         {                                                                                                    \
-            fprintf(stderr, "[%s:%d | %s] " format TERMINATOR, __FILE__, __LINE__, __func__, ##__VA_ARGS__); \
-            fflush(stderr);                                                                                  \
+            MEB_PRINT_ERR("[%s:%d | %s] " format TERMINATOR, __FILE__, __LINE__, __func__, ##__VA_ARGS__);   \
+            MEB_PRINT_FLUSH_ERR();                                                                           \
         }                                                                                                    \
     }
 #endif // dbprintf
@@ -106,30 +166,30 @@
 #if !defined(_MSC_VER)
 
 #ifndef bprintf
-#define bprintf(str, ...)                                        \
-    (                                                            \
-        {                                                        \
-            int _meb_rc = 0;                                     \
-            if (MEB_DBGLVL & MEB_DBG_BPRINT)                     \
-            {                                                    \
-                _meb_rc = printf(str TERMINATOR, ##__VA_ARGS__); \
-                fflush(stdout);                                  \
-            }                                                    \
-            _meb_rc;                                             \
+#define bprintf(str, ...)                                               \
+    (                                                                   \
+        {                                                               \
+            int _meb_rc = 0;                                            \
+            if (MEB_DBGLVL & MEB_DBG_BPRINT)                            \
+            {                                                           \
+                _meb_rc = MEB_PRINT_OUT(str TERMINATOR, ##__VA_ARGS__); \
+                MEB_PRINT_FLUSH_OUT();                                  \
+            }                                                           \
+            _meb_rc;                                                    \
         })
 #endif // bprintf
 
 #ifndef bprintlf
-#define bprintlf(str, ...)                                             \
-    (                                                                  \
-        {                                                              \
-            int _meb_rc = 0;                                           \
-            if (MEB_DBGLVL & MEB_DBG_BPRINT)                           \
-            {                                                          \
-                _meb_rc = printf(str TERMINATOR " \n", ##__VA_ARGS__); \
-                fflush(stdout);                                        \
-            }                                                          \
-            _meb_rc;                                                   \
+#define bprintlf(str, ...)                                                    \
+    (                                                                         \
+        {                                                                     \
+            int _meb_rc = 0;                                                  \
+            if (MEB_DBGLVL & MEB_DBG_BPRINT)                                  \
+            {                                                                 \
+                _meb_rc = MEB_PRINT_OUT(str TERMINATOR " \n", ##__VA_ARGS__); \
+                MEB_PRINT_FLUSH_OUT();                                        \
+            }                                                                 \
+            _meb_rc;                                                          \
         })
 #endif // bprintlf
 
@@ -138,12 +198,12 @@
 #if (MEB_DBGLVL & MEB_DBG_BPRINT)
 
 #ifndef bprintf
-#define bprintf(str, ...)                  \
+#define bprintf(str, ...) \
     printf(str TERMINATOR, ##__VA_ARGS__);
 #endif // bprintf
 
 #ifndef bprintlf
-#define bprintlf(str, ...)                       \
+#define bprintlf(str, ...) \
     printf(str TERMINATOR "\n", ##__VA_ARGS__);
 #endif // bprintlf
 
@@ -168,31 +228,37 @@
     {                                                                                               \
         if (MEB_DBGLVL & MEB_DBG_ERPRINT)                                                           \
         {                                                                                           \
-            fprintf(stderr, "[%s:%d | %s] " RED_FG "ERRNO >>> %d:" RESET_ALL " %s" TERMINATOR "\n", \
-                    __FILE__, __LINE__, __func__, error, strerror(error));                          \
-            fflush(stderr);                                                                         \
+            MEB_PRINT_ERR("[%s:%d | %s] " RED_FG "ERRNO >>> %d:" RESET_ALL " %s" TERMINATOR "\n",   \
+                          __FILE__, __LINE__, __func__, error, strerror(error));                    \
+            MEB_PRINT_FLUSH_ERR();                                                                  \
         }                                                                                           \
     }
 #endif // erprintlf
 
+// The string only changes once a second, so it is rebuilt only then.
 static inline char *get_time_now()
 {
     static __thread char buf[128];
+    static __thread time_t cached = -1;
     time_t t = time(NULL);
-    struct tm tm = *localtime(&t);
-    snprintf(buf, sizeof(buf), YELLOW_FG "[" YELLOW_FG "%02d:%02d:%02d" YELLOW_FG "] " TERMINATOR,
-             tm.tm_hour, tm.tm_min, tm.tm_sec);
+    if (t != cached)
+    {
+        struct tm tm = *localtime(&t);
+        snprintf(buf, sizeof(buf), YELLOW_FG "[" YELLOW_FG "%02d:%02d:%02d" YELLOW_FG "] " TERMINATOR,
+                 tm.tm_hour, tm.tm_min, tm.tm_sec);
+        cached = t;
+    }
     return buf;
 }
 
 #ifndef tprintf
-#define tprintf(str, ...)                                               \
-    {                                                                   \
-        if (MEB_DBGLVL & MEB_DBG_TPRINT)                                \
-        {                                                               \
-            printf("%s" str TERMINATOR, get_time_now(), ##__VA_ARGS__); \
-            fflush(stdout);                                             \
-        }                                                               \
+#define tprintf(str, ...)                                                      \
+    {                                                                          \
+        if (MEB_DBGLVL & MEB_DBG_TPRINT)                                       \
+        {                                                                      \
+            MEB_PRINT_OUT("%s" str TERMINATOR, get_time_now(), ##__VA_ARGS__); \
+            MEB_PRINT_FLUSH_OUT();                                             \
+        }                                                                      \
     }
 #endif
 
@@ -0,0 +1,139 @@
+/**
+ * @file meb_queue.hpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief A lock-free queue through which any thread can post UI work to the NCURSES thread.
+ * @version See Git tags for version information.
+ * @date 2026.10.16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MEB_QUEUE_HPP
+#define MEB_QUEUE_HPP
+
+#include <stdint.h>
+
+#include <atomic>
+#include <functional>
+#include <string>
+
+class MEBWindow;
+class MEBEventLoop;
+
+// Command kinds used by the convenience posts; commands with the same target and kind coalesce.
+#define MEB_CMD_NONE 0
+#define MEB_CMD_MOVE 1
+#define MEB_CMD_RESIZE 2
+#define MEB_CMD_PRINT(x, y) ((3ULL << 32) | ((uint64_t)(uint16_t)(y) << 16) | (uint16_t)(x))
+
+/**
+ * @brief A multi-producer, single-consumer, lock-free command queue.
+ *
+ * Any thread may Post(...) without blocking; posting never touches NCURSES. The UI thread calls Drain(), which runs
+ * the queued commands in order. Commands posted with the same non-null target and kind coalesce: only the most recent
+ * one posted before a Drain() is run, so a producer updating a value faster than the frame rate costs one redraw.
+ *
+ */
+class MEBCommandQueue
+{
+public:
+    /**
+     * @brief Creates an empty queue; constructor.
+     *
+     */
+    MEBCommandQueue();
+
+    /**
+     * @brief Discards any commands still queued; destructor.
+     *
+     */
+    ~MEBCommandQueue();
+
+    /**
+     * @brief Drains the queue on the loop's thread whenever commands are posted.
+     *
+     * Replaces the loop's OnWakeup(...) callback.
+     *
+     * @param loop The MEBEventLoop owned by the UI thread. Attach before any thread starts posting.
+     */
+    void Attach(MEBEventLoop *loop);
+
+    /**
+     * @brief Posts a command. Safe to call from any thread.
+     *
+     * @param fn The command, run on the UI thread.
+     * @param target (Optional) The object the command mutates.
+     * @param kind (Optional) The kind of mutation; with target, identifies which earlier commands this one supersedes.
+     */
+    void Post(std::function<void()> fn, const void *target = nullptr, uint64_t kind = MEB_CMD_NONE);
+
+    /**
+     * @brief Posts MEBWindow::MoveTo(...); coalesces with other moves of the same window.
+     *
+     */
+    void PostMoveTo(MEBWindow *w, int x, int y);
+
+    /**
+     * @brief Posts MEBWindow::ResizeTo(...); coalesces with other resizes of the same window.
+     *
+     */
+    void PostResizeTo(MEBWindow *w, int cols, int rows);
+
+    /**
+     * @brief Formats text on the calling thread and posts printing it into a MEBWindow; coalesces with other prints at the same position.
+     *
+     * @param w The MEBWindow.
+     * @param x Window relative x-coordinate.
+     * @param y Window relative y-coordinate.
+     * @param fmt Format string, as printf(...).
+     */
+    void PostPrint(MEBWindow *w, int x, int y, const char *fmt, ...) __attribute__((format(printf, 5, 6)));
+
+    /**
+     * @brief Runs every queued command. Call only from the UI thread.
+     *
+     * @return int The number of commands run.
+     */
+    int Drain();
+
+    /**
+     * @brief Returns true if no commands are queued. Call only from the UI thread; approximate while producers are posting.
+     *
+     */
+    bool Empty();
+
+private:
+    struct node
+    {
+        std::atomic<node *> next;
+        std::function<void()> fn;
+        const void *target;
+        uint64_t kind;
+    };
+
+    // FOR INTERNAL USE ONLY
+    node *pop();
+
+    std::atomic<node *> head; // Producers push here.
+    node *tail;               // The consumer pops here.
+    node stub;
+
+    std::atomic<bool> pending;
+    MEBEventLoop *loop;
+};
+
+#endif // MEB_QUEUE_HPP
@@ -0,0 +1,214 @@
+/**
+ * @file meb_record.hpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Records sessions, each frame's changes and every key with its time, to a compact file, and replays them.
+ * @version See Git tags for version information.
+ * @date 2026.10.16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MEB_RECORD_HPP
+#define MEB_RECORD_HPP
+
+#include <ncurses.h>
+#include <menu.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "mebgui.hpp"
+#include "meb_cells.hpp"
+
+class MEBEventLoop;
+
+// Starts every recording; the last character is the format version.
+#define MEB_RECORD_MAGIC "MEBREC\n1"
+#define MEB_RECORD_MAGIC_LEN 8
+// Bytes of recording held in memory before they are written out.
+#define MEB_RECORD_FLUSH_BYTES (64 * 1024)
+
+/**
+ * @brief Records a session: what changed on the screen each frame, and every key read, with the time of each.
+ *
+ * Once set with MEBScreen::SetRecorder(...), each composed frame is compared against the last one recorded, and the
+ * changed span of each row is appended; frames in which nothing changed are left out. MEBEventLoop appends each key
+ * it reads. Times are kept as microseconds since the previous entry, and cells as runs sharing one attribute, written
+ * a byte per character, so a recording costs a few bytes per changed character and little more. The recording is
+ * written out MEB_RECORD_FLUSH_BYTES at a time, and the rest when the recorder is destroyed.
+ *
+ * See MEBReplay to play a recording back. Only the UI thread may use a MEBRecorder.
+ *
+ */
+class MEBRecorder
+{
+public:
+    /**
+     * @brief Creates, or replaces, a recording; constructor.
+     *
+     * @param path Where to write it.
+     */
+    MEBRecorder(const char *path);
+
+    /**
+     * @brief Writes out the rest of the recording and closes it; destructor. Unset it from the MEBScreen first.
+     *
+     */
+    ~MEBRecorder();
+
+    /**
+     * @brief Records what changed on the screen since the last frame; called by MEBScreen once per frame.
+     *
+     */
+    void Frame();
+
+    /**
+     * @brief Records a key; called by MEBEventLoop for every key read.
+     *
+     * @param in The key, as returned by wgetch(...).
+     */
+    void Key(int in);
+
+    uint64_t Frames() { return frames; }; // Frames recorded; unchanged frames are not.
+    uint64_t Keys() { return keys; };
+    uint64_t Bytes() { return bytes + buf.size(); };
+
+private:
+    // FOR INTERNAL USE ONLY
+    void entry(char tag);
+    void put_varint(uint64_t v);
+    void put_span(const chtype *cells, int n);
+    void flush();
+
+    int fd;
+    std::string buf;  // Recorded but not yet written.
+    uint64_t last_us; // Time of the last entry.
+
+    MEBCellBuffer front; // The screen as last recorded.
+    MEBCellBuffer back;  // The frame being recorded.
+    std::vector<MEBRect> spans;
+
+    uint64_t frames;
+    uint64_t keys;
+    uint64_t bytes; // Written out.
+};
+
+/**
+ * @brief Plays a recording back through a MEBWindow, at its original pace or as fast as it can.
+ *
+ * The recording is mapped into memory and read in place. Each recorded frame is drawn into the window and output as a
+ * frame of its own, through MEBScreen and any MEBRenderer, so playing the same recording with two builds of the library
+ * compares what they spend on it. Recorded keys are handed to OnKey(...) before the frame which followed them, and
+ * counted by MEBStats as input, so a program can drive its own widgets with them too.
+ *
+ * Cells are drawn at the screen position they were recorded at, less the window's position, and clipped to the window.
+ *
+ */
+class MEBReplay
+{
+public:
+    /**
+     * @brief Opens a recording; constructor.
+     *
+     * @param path The recording.
+     * @param w The MEBWindow to play it into, usually one covering the whole screen.
+     */
+    MEBReplay(const char *path, MEBWindow *w);
+
+    /**
+     * @brief Unmaps the recording; destructor.
+     *
+     */
+    ~MEBReplay();
+
+    /**
+     * @brief Sets the callback for every key played back.
+     *
+     */
+    void OnKey(std::function<void(int)> cb);
+
+    /**
+     * @brief Plays the recording with the loop's timers, until it ends. Set the speed first.
+     *
+     * @param loop The MEBEventLoop owned by the UI thread.
+     */
+    void Attach(MEBEventLoop *loop);
+
+    /**
+     * @brief Sets how fast Attach(...) plays: 1 for the recorded pace, 2 for twice it, and 0 for a frame every
+     * millisecond. Call Step(...) in a loop instead to play as fast as possible.
+     *
+     */
+    void SetSpeed(double speed) { this->speed = speed > 0 ? speed : 0; };
+
+    /**
+     * @brief Plays the keys up to the next recorded frame, and the frame, as one frame, however long they took.
+     *
+     * @return true If anything was played; false at the end of the recording.
+     */
+    bool Step();
+
+    /**
+     * @brief Starts again from the beginning.
+     *
+     */
+    void Rewind();
+
+    bool Done() { return at >= end; };
+    uint64_t Frames() { return total_frames; };  // Frames in the recording.
+    uint64_t Keys() { return total_keys; };      // Keys in the recording.
+    uint64_t DurationUs() { return duration; };  // From the first entry to the last.
+    uint64_t Played() { return played; };        // Frames played since the last Rewind().
+    int RecordedCols() { return rec_cols; };     // Size of the screen most recently recorded.
+    int RecordedRows() { return rec_rows; };
+
+private:
+    // FOR INTERNAL USE ONLY
+    bool get_varint(const uint8_t *&p, uint64_t *v);
+    bool get_entry(const uint8_t *&p, char *tag, uint64_t *dt);
+    bool get_frame(const uint8_t *&p, bool draw);
+    bool scan();
+    void tick();
+
+    MEBWindow *target;
+    const uint8_t *map;
+    size_t map_len;
+    const uint8_t *start; // The first entry.
+    const uint8_t *end;   // Past the last whole entry.
+    const uint8_t *at;    // The next entry.
+
+    std::function<void(int)> key_cb;
+    MEBEventLoop *loop;
+    int timer; // Fires when the next entry is due; -1 otherwise.
+    double speed;
+    uint64_t rec_us;  // Recorded time of the last entry played, since the recording began.
+    uint64_t wall_us; // When Attach(...) began playing from the start of the recording.
+
+    std::vector<chtype> line; // Scratch for one span.
+    int rec_cols;
+    int rec_rows;
+
+    uint64_t total_frames;
+    uint64_t total_keys;
+    uint64_t duration;
+    uint64_t played;
+};
+
+#endif // MEB_RECORD_HPP
@@ -0,0 +1,194 @@
+/**
+ * @file meb_render.hpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief A double-buffered terminal renderer which can stand in for NCURSES' own screen update.
+ * @version See Git tags for version information.
+ * @date 2026.10.16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MEB_RENDER_HPP
+#define MEB_RENDER_HPP
+
+#include <ncurses.h>
+#include <menu.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "mebgui.hpp"
+#include "meb_cells.hpp"
+
+// Gaps in a row of changes up to this many cells are bridged by rewriting them rather than moving the cursor.
+#define MEB_RENDER_MAX_BRIDGE 8
+// Bytes of earlier frames still on their way to the terminal above which a frame is dropped.
+#define MEB_RENDER_DEFAULT_BUDGET 2048
+// How soon a dropped frame is tried again when the link's throughput is not yet known.
+#define MEB_RENDER_RETRY_MS 20
+// Scroll hints kept for one frame; more are ignored, and their bands repainted.
+#define MEB_RENDER_MAX_HINTS 16
+
+// A band of screen rows whose content moved up n rows (down if negative); see MEBRenderer::ScrollHint(...).
+struct MEBScrollHint
+{
+    int top;
+    int bottom;
+    int n;
+};
+
+/**
+ * @brief Outputs the NCURSES virtual screen in place of doupdate().
+ *
+ * The renderer keeps a front grid, holding what the terminal shows, and a back grid, into which each frame's virtual
+ * screen is copied. Rows are compared a vector register at a time (see MEBCellBuffer::DiffRow(...)), and only the
+ * changed span of each row is written, with absolute cursor addressing and the fewest attribute changes, into one
+ * buffer which is sent with a single write(...) per frame. NCURSES' line hashing is not attempted; on large screens with
+ * most rows changing it costs more than it saves. Instead, whatever scrolls its content says so with ScrollHint(...),
+ * and the band of rows is scrolled by the terminal, within a scroll region or else by deleting and inserting lines,
+ * whenever that and repainting what still differs takes fewer bytes than repainting the band as it is. Over a slow link
+ * a full-height scroll then costs a few bytes and the rows exposed, rather than the whole band.
+ *
+ * NCURSES' record of the terminal (curscr) is not kept up to date, as copying into it costs about as much as the rest
+ * of a frame. A stray refresh() is still output correctly, if with more bytes than needed, since the cursor is always
+ * left where NCURSES last put it and attributes are left normal.
+ *
+ * On a slow link the renderer keeps the terminal current rather than complete. Output is written without blocking,
+ * and whatever the terminal does not take is kept back. While more than the frame budget is in flight (kept back,
+ * in the terminal's output queue, or still crossing the link at its rate), frames are dropped; the next one output
+ * brings the terminal straight to the latest state. The link's rate is measured while output is kept back, but over SSH
+ * most of the queue lies on the far side of the connection, so give the rate with SetLinkRate(...). A MEBEventLoop
+ * wakes up in time to output the latest state once the link has caught up.
+ *
+ */
+class MEBRenderer
+{
+public:
+    /**
+     * @brief Creates a renderer for the screen NCURSES is driving; constructor.
+     *
+     * @param fd The file descriptor NCURSES writes the terminal's output to.
+     */
+    MEBRenderer(int fd);
+
+    /**
+     * @brief Hands the terminal back to NCURSES, which repaints it with its next update; destructor.
+     *
+     */
+    ~MEBRenderer();
+
+    /**
+     * @brief Returns whether the terminal can be driven by a MEBRenderer. It must support cursor addressing.
+     *
+     */
+    static bool Supported();
+
+    /**
+     * @brief Outputs whatever changed in the NCURSES virtual screen since the last call; called by MEBScreen.
+     *
+     */
+    void Present();
+
+    /**
+     * @brief Says that a band of whole screen rows shows, in the next frame, what it showed before moved up some rows.
+     * A hint which would not save output is ignored, so a wrong one costs nothing but the time to check it.
+     *
+     * @param top The band's first row.
+     * @param bottom The band's last row.
+     * @param n Rows the content moved up; negative if it moved down.
+     */
+    void ScrollHint(int top, int bottom, int n);
+
+    /**
+     * @brief Clears and repaints the whole terminal with the next frame.
+     *
+     */
+    void Invalidate() { full = true; };
+
+    /**
+     * @brief Sets how much earlier output may still be in flight for a frame to be output; frames are dropped beyond it.
+     *
+     * @param bytes About a frame's worth; MEB_RENDER_DEFAULT_BUDGET by default. 0 never drops frames.
+     */
+    void SetFrameBudget(size_t bytes) { budget = bytes; };
+
+    /**
+     * @brief Sets the rate at which the link carries output to the terminal, for links whose queue cannot be seen.
+     *
+     * @param bytes_per_sec The link's rate, e.g. 8000 for 64 kbit/s; 0 to measure it from the terminal's output queue.
+     */
+    void SetLinkRate(size_t bytes_per_sec) { link_rate = bytes_per_sec; };
+
+    /**
+     * @brief Returns true if the last frame was dropped or is not yet all output, so the terminal is not yet showing the latest state.
+     *
+     */
+    bool Behind() { return behind || !backlog.empty(); };
+
+    /**
+     * @brief Returns how many milliseconds until the terminal is likely to take more output, or -1 if it is current.
+     *
+     */
+    int RetryMs();
+
+    size_t GetFrameBudget() { return budget; };
+    size_t InFlight() { return in_flight; };               // Bytes output and not yet shown, as of the last frame.
+    double Throughput() { return link_rate > 0 ? link_rate : rate_est; }; // Bytes per second, or 0 if not yet known.
+
+    const MEBCellBuffer &Front() { return front; };
+
+private:
+    // FOR INTERNAL USE ONLY
+    void emit(const char *s);
+    void move_to(int y, int x);
+    void set_attr(attr_t attr);
+    void put_span(int y, int lo, int hi);
+    void scroll_band(int top, int bottom, int n);
+    size_t repaint_cost(const MEBCellBuffer &prev, int top, int bottom);
+    void emit_n(const char *parm, const char *one, int n);
+    void measure_link();
+    void drain();
+
+    int fd;
+    bool full;
+    MEBCellBuffer front; // What the terminal shows.
+    MEBCellBuffer back;  // The frame being output.
+    MEBCellBuffer shifted; // The front grid as it would be after a hinted scroll.
+    std::vector<MEBScrollHint> hints; // Not yet output, oldest first.
+    std::string out;     // Output of the frame being built.
+    int cur_y;           // Where the terminal's cursor is, or -1 if unknown.
+    int cur_x;
+    attr_t cur_attr;     // The terminal's current attributes, color pair included.
+
+    // The link to the terminal.
+    int out_fd;           // fd, or the same terminal opened again without blocking.
+    std::string backlog;  // Output the terminal has not yet taken.
+    size_t budget;
+    size_t link_rate;     // Given by SetLinkRate(...), or 0.
+    double rate_est;      // Measured while the backlog stayed full, in bytes per second; 0 until measured.
+    double model;         // Bytes taken by the terminal less what the link has carried since, at its rate.
+    size_t taken;         // Bytes taken by the terminal since the link was last measured.
+    bool backlogged;      // The backlog was not empty when the link was last measured.
+    uint64_t measured_us; // When the link was last measured.
+    size_t in_flight;
+    bool behind;
+};
+
+#endif // MEB_RENDER_HPP
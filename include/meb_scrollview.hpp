@@ -0,0 +1,157 @@
+/**
+ * @file meb_scrollview.hpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief A scrolling view onto content larger than itself, drawn into an NCURSES pad.
+ * @version See Git tags for version information.
+ * @date 2026.10.16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MEB_SCROLLVIEW_HPP
+#define MEB_SCROLLVIEW_HPP
+
+#include "mebgui.hpp"
+
+/**
+ * @brief A view inside a MEBWindow onto content larger than itself, which is drawn into an NCURSES pad.
+ *
+ * Draw into Pad() as into any window, at content coordinates; the rows in view which were drawn into are copied into
+ * the parent window with the next frame. Outside of a frame, call MEBScreen::Present() after drawing.
+ *
+ * When the view scrolls vertically by less than its height, the rows still in view are moved within the parent's
+ * cells, only the rows exposed are copied from the pad, and the move is passed on with MEBScreen::Scrolled(...). A
+ * MEBRenderer then scrolls those rows on the terminal and writes just the rows exposed, so a full-width view scrolling
+ * one line costs a few bytes and one row, whatever its height. NCURSES' own output finds the same scroll by hashing
+ * lines. Scrolling sideways copies the whole view.
+ *
+ */
+class MEBScrollView : public MEBWidget
+{
+public:
+    /**
+     * @brief Spawns a view onto blank content; constructor.
+     *
+     * @param w Parent MEBWindow.
+     * @param x Parent window relative x-axis offset.
+     * @param y Parent window relative y-axis offset.
+     * @param cols Width.
+     * @param rows Height.
+     * @param content_cols Width of the content.
+     * @param content_rows Height of the content.
+     */
+    MEBScrollView(MEBWindow *w, int x, int y, int cols, int rows, int content_cols, int content_rows);
+
+    /**
+     * @brief Destructor.
+     *
+     */
+    ~MEBScrollView();
+
+    /**
+     * @brief Returns the pad holding the content, to draw into.
+     *
+     */
+    WINDOW *Pad() { return pad; };
+
+    /**
+     * @brief Resizes the content, keeping what still fits. New cells are blank.
+     *
+     * @param cols Width of the content.
+     * @param rows Height of the content.
+     */
+    void SetContentSize(int cols, int rows);
+
+    /**
+     * @brief Scrolls the view, stopping at the edges of the content.
+     *
+     * @param drows Rows to scroll; negative is up.
+     * @param dcols Columns to scroll; negative is left.
+     */
+    void Scroll(int drows, int dcols);
+
+    /**
+     * @brief Puts a cell of the content at the top-left of the view, or as near as the edges of the content allow.
+     *
+     * @param row Content row.
+     * @param col Content column.
+     */
+    void ScrollTo(int row, int col);
+
+    /**
+     * @brief Handles arrow keys, page up / page down and home / end scrolling.
+     *
+     * @param in The user's input, retrieved via wgetch(...).
+     * @return true If the key was used.
+     */
+    bool Update(int in);
+
+    /**
+     * @brief Copies into the parent window the rows exposed by scrolling, and those drawn into; called by MEBScreen once per frame.
+     *
+     */
+    void Render();
+
+    const char *Name() { return "scrollview"; };
+
+    /**
+     * @brief Moves the view some delta-position.
+     *
+     */
+    void Move(int dx, int dy);
+
+    /**
+     * @brief Recreates the view's sub-window and copies the whole view into it.
+     *
+     */
+    void Refresh();
+
+    /**
+     * @brief Deletes the sub-window if it was made from w, which its MEBWindow is about to delete; another is made from the window's next NCURSES window.
+     *
+     */
+    void Release(WINDOW *w);
+
+    int GetTop() { return top; };
+    int GetLeft() { return left; };
+    int ContentCols() { return content_cols; };
+    int ContentRows() { return content_rows; };
+    MEBWindow *GetParent() { return parent; };
+
+private:
+    // FOR INTERNAL USE ONLY
+    void copy_rows(int first, int last);
+
+    int x;
+    int y;
+    int cols;
+    int rows;
+    MEBWindow *parent;
+    WINDOW *posted_win; // The parent's NCURSES window when the sub-window was made.
+    WINDOW *sub;
+    WINDOW *pad;
+
+    int content_cols;
+    int content_rows;
+    int top;  // Content row at the top of the view.
+    int left; // Content column at the left of the view.
+    int shown_top; // As the sub-window last showed them.
+    int shown_left;
+    bool redraw;
+};
+
+#endif // MEB_SCROLLVIEW_HPP
@@ -0,0 +1,148 @@
+/**
+ * @file meb_search.hpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief A trigram index for incremental substring search over menu items.
+ * @version See Git tags for version information.
+ * @date 2026.10.16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MEB_SEARCH_HPP
+#define MEB_SEARCH_HPP
+
+#include <stdint.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "mebgui.hpp"
+
+// Queries with more candidates than this are verified on the background thread.
+#define MEB_SEARCH_SYNC_LIMIT 32768
+// Candidates verified between publications of partial results.
+#define MEB_SEARCH_CHUNK 16384
+
+/**
+ * @brief A case-insensitive substring index over item titles and descriptions.
+ *
+ * Every trigram of every item is hashed into one of 65536 buckets, each holding the sorted list of items containing
+ * it. A query intersects the lists of its own trigrams and verifies the few survivors. A query extending the previous
+ * one only re-checks the previous matches. Small candidate sets are verified immediately; large ones are verified on a
+ * background thread and published in chunks as they are found.
+ *
+ * Build(...) builds the new index aside, then drops any queued job and waits for any search on the background thread
+ * to be abandoned before swapping it in. Query(...) and Fetch(...) are meant for the UI thread.
+ *
+ */
+class MEBSearchIndex
+{
+public:
+    /**
+     * @brief Creates an empty index; constructor.
+     *
+     */
+    MEBSearchIndex();
+
+    /**
+     * @brief Stops the background thread; destructor.
+     *
+     */
+    ~MEBSearchIndex();
+
+    /**
+     * @brief Indexes items supplied by a source. May be called from any thread, provided the source is safe there.
+     *
+     * @param n_items Number of items.
+     * @param source Called once for each item.
+     */
+    void Build(int n_items, MEBMenuSource source);
+
+    /**
+     * @brief Sets the callback run, on the background thread, whenever partial results are published. Typically MEBEventLoop::Wakeup().
+     *
+     * @param cb The callback.
+     */
+    void OnProgress(std::function<void()> cb);
+
+    /**
+     * @brief Starts a search, superseding any search still running. Returns immediately.
+     *
+     * @param query The text to look for; an empty query matches everything.
+     */
+    void Query(const char *query);
+
+    /**
+     * @brief Brings a copy of the results up to date.
+     *
+     * @param out The caller's copy of the results, as item indices in ascending order. Only newly published results are appended.
+     * @param generation The generation out reflects; updated. Start from 0.
+     * @return true If out changed.
+     */
+    bool Fetch(std::vector<int> &out, uint64_t &generation);
+
+    /**
+     * @brief Returns true once the current search has finished.
+     *
+     */
+    bool Complete() { return complete; };
+
+    int Count() { return n_items; };
+
+private:
+    // FOR INTERNAL USE ONLY
+    static uint32_t bucket(const unsigned char *p);
+    bool matches(int item, const std::string &q);
+    void worker();
+
+    int n_items;
+
+    // Lower-cased "title\ndesc" of every item, back to back.
+    std::vector<char> text;
+    std::vector<uint32_t> text_off;
+
+    // Bucketed trigram postings, in compressed-row form.
+    std::vector<uint32_t> post_off;
+    std::vector<int> postings;
+
+    // The search in progress. results and generation are shared with the worker under lock.
+    std::mutex lock;
+    std::condition_variable cv;
+    std::condition_variable idle; // Signalled when the worker lets go of the index.
+    std::thread thread;
+    bool quit;
+    bool job_ready;
+    bool busy; // The worker is reading the index.
+    std::atomic<bool> complete;
+    std::atomic<uint64_t> generation; // Bumped by Query(...); the worker abandons stale jobs.
+    uint64_t job_gen; // The generation the queued job was made for.
+    std::string job_query;
+    bool job_all; // Candidates are every item, rather than job_candidates.
+    std::vector<int> job_candidates;
+    std::vector<int> results;
+    uint64_t results_gen;
+    std::string results_query;
+
+    std::function<void()> progress_cb;
+};
+
+#endif // MEB_SEARCH_HPP
@@ -0,0 +1,136 @@
+/**
+ * @file meb_share.hpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Streams every frame to viewers attached over a Unix domain socket.
+ * @version See Git tags for version information.
+ * @date 2026.10.16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MEB_SHARE_HPP
+#define MEB_SHARE_HPP
+
+#include <ncurses.h>
+#include <menu.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mebgui.hpp"
+#include "meb_cells.hpp"
+
+class MEBEventLoop;
+
+// Most viewers attached at once; further connections are closed.
+#define MEB_SHARE_MAX_CLIENTS 32
+// Bytes queued for one viewer beyond which its queue is dropped, and it is sent the whole screen again.
+#define MEB_SHARE_MAX_BACKLOG (256 * 1024)
+// How often queued output is retried while a viewer is not taking it.
+#define MEB_SHARE_RETRY_MS 10
+
+/**
+ * @brief Shares the screen, read-only, with any number of viewers connected to a Unix domain socket.
+ *
+ * Once set with MEBScreen::SetShare(...), each frame is compared against the last one shared, and what changed is
+ * encoded once as ANSI escape sequences. One reference-counted copy of the encoding is queued for every viewer, and
+ * sent to each without blocking. A viewer which falls MEB_SHARE_MAX_BACKLOG behind has its queue dropped and is sent
+ * the whole screen with the next frame instead, as a newly connected viewer is, so a slow viewer holds up neither the
+ * process nor the other viewers. Any terminal understanding ANSI sequences can view, for example with
+ * `socat -u UNIX-CONNECT:<path> STDOUT`; it should be at least as large as the shared screen.
+ *
+ * The process may itself run headless (see ncurses_init_headless(...)). Only the UI thread may use a MEBShare.
+ *
+ */
+class MEBShare
+{
+public:
+    /**
+     * @brief Listens for viewers; constructor. A stale socket left at the path is replaced.
+     *
+     * @param path Where to create the socket.
+     */
+    MEBShare(const char *path);
+
+    /**
+     * @brief Disconnects every viewer and removes the socket; destructor. Unset it from the MEBScreen first.
+     *
+     */
+    ~MEBShare();
+
+    /**
+     * @brief Accepts viewers and retries queued output as the loop runs, rather than only when frames are output.
+     *
+     * @param loop The MEBEventLoop owned by the UI thread.
+     */
+    void Attach(MEBEventLoop *loop);
+
+    /**
+     * @brief Encodes what changed since the last frame and sends it to every viewer; called by MEBScreen once per frame.
+     *
+     */
+    void Broadcast();
+
+    int Clients() { return clients.size(); };
+    uint64_t Frames() { return frames; };           // Frames encoded for viewers.
+    uint64_t BytesEncoded() { return encoded; };    // Bytes encoded, once however many viewers they went to.
+    uint64_t Resyncs() { return resyncs; };         // Whole screens sent to viewers that connected or fell behind.
+    const char *GetPath() { return path.c_str(); };
+
+private:
+    typedef std::shared_ptr<const std::string> frame;
+
+    struct client
+    {
+        int fd;
+        std::deque<frame> queue; // Oldest first; the first may be partly sent.
+        size_t sent;             // Bytes of the first already sent.
+        size_t queued;           // Bytes in the queue not yet sent.
+        bool resync;             // Needs the whole screen next.
+    };
+
+    // FOR INTERNAL USE ONLY
+    void accept_clients();
+    void on_client(int fd);
+    void drop(size_t i);
+    frame encode(const MEBCellBuffer &was);
+    void put_attr(std::string &out, attr_t attr);
+    void flush(client &c);
+    void flush_all();
+    void arm();
+
+    std::string path;
+    int listen_fd;
+    MEBEventLoop *loop;
+    int timer; // Retries queued output, while there is any; -1 otherwise.
+
+    std::vector<client> clients;
+    MEBCellBuffer front; // The screen as last shared.
+    MEBCellBuffer back;  // The frame being shared.
+    MEBCellBuffer blank; // What a cleared terminal shows, to encode the whole screen against.
+    attr_t cur_attr;     // Attributes at the current point of the encoding.
+
+    uint64_t frames;
+    uint64_t encoded;
+    uint64_t resyncs;
+};
+
+#endif // MEB_SHARE_HPP
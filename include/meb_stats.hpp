@@ -0,0 +1,192 @@
+/**
+ * @file meb_stats.hpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Rendering counters, frame statistics and a live overlay showing them.
+ * @version See Git tags for version information.
+ * @date 2026.10.16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MEB_STATS_HPP
+#define MEB_STATS_HPP
+
+#include <stdint.h>
+
+#include <string>
+
+#include "mebgui.hpp"
+
+// Histogram buckets; bucket i counts samples up to 2^i not counted by bucket i - 1, the last also everything larger.
+#define MEB_STATS_BUCKETS 24
+// How often the overlay redraws its figures.
+#define MEB_STATS_HUD_MS 250
+
+/**
+ * @brief A histogram with power-of-two buckets.
+ *
+ */
+struct MEBHistogram
+{
+    uint64_t count;
+    uint64_t sum;
+    uint64_t max;
+    uint64_t buckets[MEB_STATS_BUCKETS];
+
+    void Add(uint64_t value);
+
+    /**
+     * @brief Returns the upper bound of the bucket holding the given fraction of samples.
+     *
+     * @param p The fraction, e.g. 0.99.
+     */
+    uint64_t Percentile(double p) const;
+};
+
+/**
+ * @brief Screen-wide counters.
+ *
+ */
+struct MEBScreenCounters
+{
+    uint64_t frames;            // Calls to doupdate(), one per frame.
+    uint64_t refreshes;         // Windows staged for output, summed over all frames.
+    uint64_t windows_created;   // NCURSES windows created for MEBWindows.
+    uint64_t windows_destroyed; // NCURSES windows deleted for MEBWindows.
+    uint64_t rows_culled;       // Changed window rows not staged because windows above hid them.
+    uint64_t frames_dropped;    // Frames a MEBRenderer did not output because the terminal was behind.
+    uint64_t bytes_written;     // Bytes written to the terminal by doupdate(), while enabled.
+    uint64_t write_calls;       // write(...) system calls made by doupdate(), while enabled.
+    MEBHistogram frame_us;      // Time to render, compose and output each frame, in microseconds, while enabled.
+    MEBHistogram frame_bytes;   // Bytes written per frame, while enabled.
+    MEBHistogram input_us;      // Time from input arriving to the frame showing its effect, in microseconds, while enabled.
+};
+
+/**
+ * @brief Collects rendering statistics.
+ *
+ * Plain counts are always kept, here and in the counters of every MEBWindow and widget. Timings and terminal output
+ * are only measured once Enable(...) is called, since they cost a few system calls per frame. Output is measured with
+ * the UI thread's I/O accounting from /proc, so it covers exactly what NCURSES wrote, however it was buffered.
+ *
+ */
+class MEBStats
+{
+public:
+    /**
+     * @brief Returns the one MEBStats.
+     *
+     */
+    static MEBStats *Get();
+
+    /**
+     * @brief Enables or disables timing and output measurement. Call from the UI thread.
+     *
+     * @param enable True to enable.
+     */
+    void Enable(bool enable);
+
+    bool Enabled() { return enabled; };
+
+    /**
+     * @brief Zeroes every counter, including those of registered windows and widgets.
+     *
+     */
+    void Reset();
+
+    const MEBScreenCounters &Counters() { return counters; };
+
+    /**
+     * @brief Writes every counter in the Prometheus text exposition format.
+     *
+     * @param out Appended to.
+     */
+    void Format(std::string &out);
+
+    /**
+     * @brief Writes the counters, as Format(...), to a file or a Unix domain socket.
+     *
+     * Files are replaced atomically, so a reader never sees a partial dump.
+     *
+     * @param target A file path, or "unix:" followed by the path of a listening stream socket.
+     * @return int 0 on success, -1 on failure with errno set.
+     */
+    int Dump(const char *target);
+
+    // Called by MEBScreen and MEBEventLoop.
+    void FrameStarted();
+    void OutputStarted();
+    void FrameFinished();
+    void InputArrived();
+    uint64_t Now();
+
+    // Counted directly by mebgui.
+    MEBScreenCounters counters;
+
+private:
+    MEBStats();
+
+    // FOR INTERNAL USE ONLY
+    bool read_io(uint64_t *wchar, uint64_t *syscw);
+
+    bool enabled;
+    int io_fd; // The UI thread's /proc I/O accounting.
+
+    uint64_t frame_start;
+    uint64_t input_start; // 0 if no input is waiting to be shown.
+    uint64_t io_wchar;
+    uint64_t io_syscw;
+};
+
+/**
+ * @brief An overlay window showing the statistics live.
+ *
+ */
+class MEBStatsHUD : public MEBWidget
+{
+public:
+    /**
+     * @brief Opens the overlay, on top of existing windows, and enables MEBStats; constructor.
+     *
+     * @param x X-positional coordinate (left-right).
+     * @param y Y-positional coordinate (up-down).
+     */
+    MEBStatsHUD(int x, int y);
+
+    /**
+     * @brief Closes the overlay; destructor.
+     *
+     */
+    ~MEBStatsHUD();
+
+    /**
+     * @brief Redraws the figures, at most every MEB_STATS_HUD_MS; called by MEBScreen once per frame.
+     *
+     */
+    void Render();
+
+    const char *Name() { return "hud"; };
+
+    MEBWindow *GetWindow() { return window; };
+
+private:
+    MEBWindow *window;
+    uint64_t drawn_at;
+    uint64_t drawn_frames;
+};
+
+#endif // MEB_STATS_HPP
@@ -0,0 +1,299 @@
+/**
+ * @file meb_table.hpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief A scrolling table of typed columns, drawing only the cells in view which changed.
+ * @version See Git tags for version information.
+ * @date 2026.10.16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MEB_TABLE_HPP
+#define MEB_TABLE_HPP
+
+#include <stdint.h>
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "mebgui.hpp"
+
+class MEBEventLoop;
+
+// Widest a column may be, in cells.
+#define MEB_TABLE_CELL_MAX 63
+// Least time between background sorts while the sorted column keeps changing.
+#define MEB_TABLE_RESORT_MS 500
+
+/**
+ * @brief What a table column holds.
+ *
+ */
+enum MEBColumnType
+{
+    MEB_COLUMN_INT,    // int64_t, formatted as a long long.
+    MEB_COLUMN_DOUBLE, // double.
+    MEB_COLUMN_STRING, // Text, left-aligned and truncated to the column.
+};
+
+/**
+ * @brief A table inside a MEBWindow, with a header row and scrolling in both directions.
+ *
+ * Each column is one array of its own type, so setting a value stores a number and nothing is formatted until it is
+ * drawn. Only the rows and columns in view are ever formatted. Setting a value in view marks just that cell; Render()
+ * draws the marked cells, and the whole view only when it scrolls, is sorted again or is placed anew. Values set
+ * outside a frame are each output as they are set, so update many cells from within one frame (see
+ * MEBScreen::BeginFrame()), as the event loop's callbacks are.
+ *
+ * SortBy(...) copies the column's keys to a background thread and returns at once; the table keeps its current order
+ * until the sort finishes, and a frame later shows the result. While the sorted column keeps changing, it is sorted
+ * again in the background at most every MEB_TABLE_RESORT_MS. Rows appended meanwhile are shown after the sorted ones.
+ *
+ * Rows and columns are addressed by the index they were added at, whatever the display order. Only the UI thread may
+ * call the table's methods.
+ *
+ */
+class MEBTable : public MEBWidget
+{
+public:
+    /**
+     * @brief Spawns an empty table; constructor.
+     *
+     * @param w Parent MEBWindow.
+     * @param x Parent window relative x-axis offset.
+     * @param y Parent window relative y-axis offset.
+     * @param cols Width.
+     * @param rows Height, including the header row.
+     */
+    MEBTable(MEBWindow *w, int x, int y, int cols, int rows);
+
+    /**
+     * @brief Stops the background thread; destructor.
+     *
+     */
+    ~MEBTable();
+
+    /**
+     * @brief Wakes the loop when a background sort finishes, so its result is shown without waiting for other activity.
+     *
+     * @param loop The MEBEventLoop owned by the UI thread.
+     */
+    void Attach(MEBEventLoop *loop);
+
+    /**
+     * @brief Adds a column to the right of the others. Existing rows hold 0 or an empty string in it.
+     *
+     * @param name Shown in the header.
+     * @param type What the column holds.
+     * @param width Cells wide, up to MEB_TABLE_CELL_MAX.
+     * @param fmt (Optional) printf(...) format of one long long or double, for number columns.
+     * @return int The column's index.
+     */
+    int AddColumn(const char *name, MEBColumnType type, int width, const char *fmt = nullptr);
+
+    /**
+     * @brief Adds or removes rows at the end.
+     *
+     * @param n_rows The new number of rows.
+     */
+    void SetRowCount(int n_rows);
+
+    /**
+     * @brief Adds a row at the end.
+     *
+     * @return int The row's index.
+     */
+    int AppendRow();
+
+    /**
+     * @brief Sets a value in an integer column.
+     *
+     * @param row The row's index.
+     * @param col The column's index.
+     * @param value The value.
+     */
+    void SetInt(int row, int col, int64_t value);
+
+    /**
+     * @brief Sets a value in a floating-point column.
+     *
+     */
+    void SetDouble(int row, int col, double value);
+
+    /**
+     * @brief Sets a value in a text column.
+     *
+     */
+    void SetString(int row, int col, const char *value);
+
+    int64_t GetInt(int row, int col);
+    double GetDouble(int row, int col);
+    const char *GetString(int row, int col);
+
+    /**
+     * @brief Orders the rows by a column, in the background.
+     *
+     * @param col The column's index, or -1 to show rows in the order they were added.
+     * @param descending True for largest first.
+     */
+    void SortBy(int col, bool descending = false);
+
+    /**
+     * @brief Returns true while a background sort has yet to be shown.
+     *
+     */
+    bool Sorting() { return sort_running; };
+
+    /**
+     * @brief Scrolls the view.
+     *
+     * @param drows Rows to scroll; negative is up.
+     * @param dcols Columns (not cells) to scroll; negative is left.
+     */
+    void Scroll(int drows, int dcols);
+
+    /**
+     * @brief Scrolls the view to put a display position at the top and a column at the left.
+     *
+     * @param pos Display position, from 0.
+     * @param col Column index.
+     */
+    void ScrollTo(int pos, int col);
+
+    /**
+     * @brief Handles arrow keys, page up / page down and home / end scrolling.
+     *
+     * @param in The user's input, retrieved via wgetch(...).
+     * @return true If the key was used.
+     */
+    bool Update(int in);
+
+    /**
+     * @brief Adopts a finished sort and draws whatever changed since the last frame; called by MEBScreen once per frame.
+     *
+     */
+    void Render();
+
+    const char *Name() { return "table"; };
+
+    /**
+     * @brief Moves the table some delta-position.
+     *
+     */
+    void Move(int dx, int dy);
+
+    /**
+     * @brief Recreates the table's sub-window and redraws it.
+     *
+     */
+    void Refresh();
+
+    /**
+     * @brief Deletes the sub-window if it was made from w, which its MEBWindow is about to delete; another is made from the window's next NCURSES window.
+     *
+     */
+    void Release(WINDOW *w);
+
+    /**
+     * @brief Returns the index of the row shown at a display position.
+     *
+     * @param pos Display position, from 0.
+     */
+    int RowAt(int pos) { return sorted ? order[pos] : pos; };
+
+    int GetRowCount() { return n_rows; };
+    int GetColumnCount() { return columns.size(); };
+    int GetSortColumn() { return sort_col; };
+    int GetTop() { return top; };
+    int GetLeft() { return left; };
+    MEBWindow *GetParent() { return parent; };
+
+private:
+    struct column
+    {
+        std::string name;
+        MEBColumnType type;
+        int width;
+        std::string fmt;
+        std::vector<int64_t> ints;
+        std::vector<double> reals;
+        std::vector<std::string> strs;
+    };
+
+    // FOR INTERNAL USE ONLY
+    column &cell_column(int row, int col, MEBColumnType type);
+    void changed(int row, int col);
+    void format_cell(int row, int col, char *out);
+    void layout_columns();
+    void draw_header();
+    void draw_cell(int r, int col, int cx);
+    void start_sort();
+    void adopt_sort();
+    void worker();
+
+    int x;
+    int y;
+    int cols;
+    int rows;
+    MEBWindow *parent;
+    WINDOW *posted_win; // The parent's NCURSES window when the sub-window was made.
+    WINDOW *sub;
+    MEBEventLoop *loop;
+
+    std::vector<column> columns;
+    int n_rows;
+
+    // Display order, while sorted: order[pos] is the row shown at pos, and rank[row] its position.
+    bool sorted;
+    std::vector<int> order;
+    std::vector<int> rank;
+    int sort_col;
+    bool sort_desc;
+    bool sort_stale;   // The sorted column changed since the sort started.
+    bool sort_running; // A sort has been started and not yet adopted.
+    uint64_t sort_gen; // Bumped by SortBy(...); results of earlier sorts are dropped.
+    uint64_t sort_started_us;
+
+    // View.
+    int top;  // Display position of the first row shown.
+    int left; // Index of the first column shown.
+    bool redraw;
+    std::vector<uint8_t> dirty; // One flag per cell of the body in view, row-major over every column.
+    int n_dirty;
+    std::vector<int> col_x; // Where each column in view starts, from left; -1 if out of view.
+
+    // The background sort. Everything below is shared with the worker under lock.
+    std::mutex lock;
+    std::condition_variable cv;
+    std::thread thread;
+    bool quit;
+    bool job_ready;
+    uint64_t job_gen;
+    MEBColumnType job_type;
+    bool job_desc;
+    std::vector<int64_t> job_ints;
+    std::vector<double> job_reals;
+    std::vector<std::string> job_strs;
+    bool result_ready;
+    uint64_t result_gen;
+    std::vector<int> result;
+};
+
+#endif // MEB_TABLE_HPP
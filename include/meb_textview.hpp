@@ -0,0 +1,232 @@
+/**
+ * @file meb_textview.hpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief A pager over a memory-mapped file of any size, indexing its lines on a background thread.
+ * @version See Git tags for version information.
+ * @date 2026.10.16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MEB_TEXTVIEW_HPP
+#define MEB_TEXTVIEW_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "mebgui.hpp"
+
+class MEBEventLoop;
+
+// Lines between the first checkpoints of the index; doubled whenever the index fills.
+#define MEB_TEXTVIEW_STRIDE 256
+// Most checkpoints kept, which bounds the index to 8 bytes each whatever the file's size.
+#define MEB_TEXTVIEW_MAX_CHECKPOINTS 65536
+// Bytes indexed between publications of progress; a multiple of the page size.
+#define MEB_TEXTVIEW_CHUNK (4 << 20)
+// Columns between tab stops.
+#define MEB_TEXTVIEW_TAB 8
+// Width of the line number gutter, including the space after the number.
+#define MEB_TEXTVIEW_GUTTER 11
+
+/**
+ * @brief A read-only view of a text file inside a MEBWindow, for files far too large to load.
+ *
+ * The file is mapped into memory, and only the lines in view are ever read to draw them. Scrolling, and jumping to a
+ * byte offset, find line breaks next to the view, so they need no index and cost the same anywhere in the file. Lines
+ * scrolled are passed on with MEBScreen::Scrolled(...), so a MEBRenderer outputs only the lines scrolled into view.
+ *
+ * Jumping to a line number uses an index built on a background thread, which counts line breaks sixteen bytes at a
+ * time with SSE2 where available. It records where every MEB_TEXTVIEW_STRIDE-th line starts; when that would take
+ * more than MEB_TEXTVIEW_MAX_CHECKPOINTS, every other checkpoint is dropped and the stride doubled. A jump starts at
+ * the nearest checkpoint and counts forward at most one stride, and the index never takes more than 512 KiB. The part
+ * indexed so far is usable at once: a jump past it goes as far as is known, and on to the line once it is indexed.
+ * Pages the indexer has read are released behind it, so neither the index nor the mapping holds memory in proportion
+ * to the file.
+ *
+ * The file must not be truncated while it is viewed. Only the UI thread may call the view's methods.
+ *
+ */
+class MEBTextView : public MEBWidget
+{
+public:
+    /**
+     * @brief Maps a file and starts indexing it; constructor.
+     *
+     * @param w Parent MEBWindow.
+     * @param x Parent window relative x-axis offset.
+     * @param y Parent window relative y-axis offset.
+     * @param cols Width.
+     * @param rows Height.
+     * @param path The file.
+     */
+    MEBTextView(MEBWindow *w, int x, int y, int cols, int rows, const char *path);
+
+    /**
+     * @brief Stops indexing and unmaps the file; destructor.
+     *
+     */
+    ~MEBTextView();
+
+    /**
+     * @brief Wakes the loop as indexing progresses, so line numbers and jumps waiting on it are shown without waiting for other activity.
+     *
+     * @param loop The MEBEventLoop owned by the UI thread.
+     */
+    void Attach(MEBEventLoop *loop);
+
+    /**
+     * @brief Scrolls the view.
+     *
+     * @param dlines Lines to scroll; negative is up.
+     * @param dcols Columns to scroll; negative is left.
+     */
+    void Scroll(int64_t dlines, int dcols);
+
+    /**
+     * @brief Puts a line at the top of the view. If it has yet to be indexed, goes to the last line indexed, and on to it once it is.
+     *
+     * @param line The line, from 0.
+     */
+    void GoToLine(uint64_t line);
+
+    /**
+     * @brief Puts the line holding a byte at the top of the view.
+     *
+     * @param offset The byte's offset in the file.
+     */
+    void GoToOffset(uint64_t offset);
+
+    /**
+     * @brief Shows the last page of the file.
+     *
+     */
+    void GoToEnd();
+
+    /**
+     * @brief Shows line numbers down the left side; those not yet indexed are shown as '?'.
+     *
+     */
+    void SetLineNumbers(bool show);
+
+    /**
+     * @brief Handles arrow keys, page up / page down and home / end scrolling.
+     *
+     * @param in The user's input, retrieved via wgetch(...).
+     * @return true If the key was used.
+     */
+    bool Update(int in);
+
+    /**
+     * @brief Draws the lines in view if the view changed, or indexing resolved something shown; called by MEBScreen once per frame.
+     *
+     */
+    void Render();
+
+    const char *Name() { return "textview"; };
+
+    /**
+     * @brief Moves the view some delta-position.
+     *
+     */
+    void Move(int dx, int dy);
+
+    /**
+     * @brief Recreates the view's sub-window and redraws it.
+     *
+     */
+    void Refresh();
+
+    /**
+     * @brief Deletes the sub-window if it was made from w, which its MEBWindow is about to delete; another is made from the window's next NCURSES window.
+     *
+     */
+    void Release(WINDOW *w);
+
+    /**
+     * @brief Returns the number of the line at the top of the view, or -1 if it has yet to be indexed.
+     *
+     */
+    int64_t GetTopLine();
+
+    /**
+     * @brief Returns the number of lines indexed so far; every line once Indexed().
+     *
+     */
+    uint64_t LineCount();
+
+    /**
+     * @brief Returns the number of bytes indexed so far.
+     *
+     */
+    uint64_t IndexedBytes();
+
+    bool Indexed() { return complete; };
+    uint64_t GetTopOffset() { return top; };
+    uint64_t Size() { return size; };
+    int GetLeft() { return left; };
+    MEBWindow *GetParent() { return parent; };
+
+private:
+    // FOR INTERNAL USE ONLY
+    uint64_t line_start(uint64_t offset);
+    int64_t line_of(uint64_t offset);
+    bool offset_of(uint64_t line, uint64_t *offset);
+    void draw_line(int r, const char *s, const char *e, int64_t line);
+    void worker();
+
+    int x;
+    int y;
+    int cols;
+    int rows;
+    MEBWindow *parent;
+    WINDOW *posted_win; // The parent's NCURSES window when the sub-window was made.
+    WINDOW *sub;
+
+    const char *map;
+    uint64_t size;
+
+    // View.
+    uint64_t top;     // Offset of the first line shown.
+    int64_t top_line; // Its number, or -1 until indexing reaches it.
+    int left;         // Columns scrolled off to the left.
+    bool numbers;
+    int64_t goto_line; // A line jumped to before it was indexed, or -1.
+    int64_t scrolled;  // Lines scrolled down since the last Render(); negative if up.
+    bool redraw;
+    std::string line; // Scratch for one row.
+
+    // The index. Everything below is shared with the worker under lock.
+    std::mutex lock;
+    std::thread thread;
+    std::atomic<bool> quit;
+    std::atomic<bool> pending; // Indexing progressed since the last Render().
+    MEBEventLoop *loop;
+    std::vector<uint64_t> checkpoints; // checkpoints[k] is where line k * stride starts.
+    uint64_t stride;
+    uint64_t indexed_bytes;
+    uint64_t indexed_lines; // Line breaks in the bytes indexed.
+    std::atomic<bool> complete;
+};
+
+#endif // MEB_TEXTVIEW_HPP
@@ -25,6 +25,15 @@
 #ifndef MEBGUI_HPP
 #define MEBGUI_HPP
 
+#include <stdint.h>
+
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "meb_arena.hpp"
+
 #define MIN_WIN_WIDTH 10
 #define MAX_WIN_TITLE 64
 #define MAX_MENU_MARK 64
@@ -33,12 +42,23 @@
 
 #define DEFAULT_W_TIMEOUT 5
 
+/**
+ * @brief How frames are output to the terminal.
+ *
+ */
+enum MEBRenderMode
+{
+    MEB_RENDER_NCURSES, // NCURSES' doupdate().
+    MEB_RENDER_NATIVE,  // A MEBRenderer (meb_render.cpp), for large screens with much of them changing every frame.
+};
+
 /**
  * @brief To be called at the beginning of the program, initializes NCURSES-specific items.
  *
  * @param timeout Input timeout.
+ * @param mode (Optional) How frames are output. MEB_RENDER_NATIVE falls back to NCURSES if the terminal cannot support it.
  */
-void ncurses_init(int timeout);
+void ncurses_init(int timeout, MEBRenderMode mode = MEB_RENDER_NCURSES);
 
 /**
  * @brief To be called at the end of the program, cleans up NCURSES-specific items.
@@ -46,10 +66,274 @@ void ncurses_init(int timeout);
  */
 void ncurses_cleanup();
 
-// TODO: Add automatic terminal-size-based resizing.
+/**
+ * @brief Initializes NCURSES without a terminal, in place of ncurses_init(...). Output is discarded and there is no input, so frames can be built and snapshotted (see MEBScreen::Snapshot(...)) with no TTY attached.
+ *
+ * @param cols Columns of the screen.
+ * @param rows Rows of the screen.
+ * @param mode (Optional) How frames are output.
+ */
+void ncurses_init_headless(int cols, int rows, MEBRenderMode mode = MEB_RENDER_NCURSES);
+
+/**
+ * @brief A rectangle in screen coordinates.
+ *
+ */
+struct MEBRect
+{
+    int x;
+    int y;
+    int cols;
+    int rows;
+};
+
+class MEBWindow;
+class MEBSearchIndex;
+class MEBCellBuffer;
+class MEBRenderer;
+class MEBLayout;
+class MEBShare;
+class MEBRecorder;
+
+/**
+ * @brief Counters kept for every MEBWindow and widget; see MEBStats.
+ *
+ */
+struct MEBCounters
+{
+    uint64_t refreshes;   // Frames in which the window had changes to stage for output.
+    uint64_t moves;       // Calls to Move(...) / MoveTo(...).
+    uint64_t resizes;     // Calls to Resize(...) / ResizeTo(...).
+    uint64_t recreations; // Times the NCURSES window was created anew.
+    uint64_t renders;     // Widgets only: calls to Render().
+    uint64_t render_us;   // Widgets only: microseconds spent in Render() while MEBStats is enabled.
+};
+
+/**
+ * @brief Base class for anything drawn inside a MEBWindow which needs to do work once per frame.
+ *
+ */
+class MEBWidget
+{
+public:
+    MEBWidget() : counters() {};
+    virtual ~MEBWidget() {};
+
+    /**
+     * @brief Called by MEBScreen at the end of every frame, before the screen is composed.
+     *
+     */
+    virtual void Render() = 0;
+
+    /**
+     * @brief Returns the kind of widget, as used to label its counters.
+     *
+     */
+    virtual const char *Name() { return "widget"; };
+
+    /**
+     * @brief Called before a MEBWindow deletes its NCURSES window, which NCURSES refuses while sub-windows of it remain. Widgets drawing into a sub-window of w delete it here.
+     *
+     * @param w The NCURSES window about to be deleted.
+     */
+    virtual void Release(WINDOW *w) {};
+
+    MEBCounters counters;
+};
+
+/**
+ * @brief The virtual screen which all MEBWindows and widgets register with.
+ *
+ * Windows and widgets stage their output into the NCURSES virtual screen. Output staged between BeginFrame() and EndFrame() is flushed to the terminal with a single doupdate(), or MEBRenderer::Present(), when the outermost frame ends. Outside of a frame every change is flushed immediately, as before.
+ *
+ */
+class MEBScreen
+{
+public:
+    /**
+     * @brief Returns the one MEBScreen.
+     *
+     */
+    static MEBScreen *Get();
+
+    /**
+     * @brief Opens a frame. Frames may be nested; only the outermost EndFrame() flushes.
+     *
+     */
+    void BeginFrame();
+
+    /**
+     * @brief Closes a frame, rendering widgets and flushing all staged output with a single physical update.
+     *
+     */
+    void EndFrame();
+
+    /**
+     * @brief Returns true while a frame is open.
+     *
+     */
+    bool InFrame() { return frame_depth > 0; };
+
+    /**
+     * @brief Flushes staged output now, or at the end of the current frame if one is open.
+     *
+     */
+    void Present();
+
+    /**
+     * @brief Marks a screen rectangle as needing repair from whatever lies beneath it.
+     *
+     * @param x X-positional coordinate (left-right).
+     * @param y Y-positional coordinate (up-down).
+     * @param cols Columns wide.
+     * @param rows Rows tall.
+     */
+    void Damage(int x, int y, int cols, int rows);
+
+    /**
+     * @brief Marks the part of rectangle a not covered by rectangle b as damaged.
+     *
+     * @param a The rectangle previously covered.
+     * @param b The rectangle now covered.
+     */
+    void DamageExposed(const MEBRect &a, const MEBRect &b);
+
+    /**
+     * @brief Says that the content of a window moved up some rows in this frame, so a MEBRenderer may scroll the rows on the terminal rather than repaint them. NCURSES' own output finds such scrolls itself.
+     *
+     * @param w The window, or sub-window, whose content moved.
+     * @param n Rows it moved up; negative if it moved down.
+     */
+    void Scrolled(WINDOW *w, int n);
+
+    /**
+     * @brief Copies the screen as composed so far, stdscr and then every window bottom-most first, into a cell grid sized to the screen. Reads only the NCURSES virtual screen; nothing is output.
+     *
+     * @param out The grid.
+     */
+    void Snapshot(MEBCellBuffer &out);
+
+    /**
+     * @brief Outputs frames with a MEBRenderer instead of doupdate(). Set by ncurses_init(...).
+     *
+     * @param r The renderer, which the MEBScreen does not own; nullptr for doupdate().
+     */
+    void SetRenderer(MEBRenderer *r) { renderer = r; };
+
+    MEBRenderer *GetRenderer() { return renderer; };
+
+    /**
+     * @brief Streams every frame to the viewers of a MEBShare, once the screen is composed and before it is output.
+     *
+     * @param s The share, which the MEBScreen does not own; nullptr for none.
+     */
+    void SetShare(MEBShare *s) { share = s; };
+
+    MEBShare *GetShare() { return share; };
+
+    /**
+     * @brief Records every frame, and every key MEBEventLoop reads, with a MEBRecorder.
+     *
+     * @param r The recorder, which the MEBScreen does not own; nullptr for none.
+     */
+    void SetRecorder(MEBRecorder *r) { recorder = r; };
+
+    MEBRecorder *GetRecorder() { return recorder; };
+
+    /**
+     * @brief Lays the screen out with a MEBLayout, applied at the start of every frame in which the terminal was resized or the layout changed.
+     *
+     * @param root The root of the layout, which the MEBScreen does not own; nullptr for none.
+     */
+    void SetLayout(MEBLayout *root);
+
+    MEBLayout *GetLayout() { return layout; };
+
+    /**
+     * @brief Moves a window, and its descendants, above all others. Descendants keep their order among themselves.
+     *
+     * @param w The window.
+     */
+    void Raise(MEBWindow *w);
+
+    /**
+     * @brief Moves a window, and its descendants, beneath all others. Descendants stay above the window.
+     *
+     * @param w The window.
+     */
+    void Lower(MEBWindow *w);
+
+    void Register(MEBWindow *w);
+    void Unregister(MEBWindow *w);
+    void Register(MEBWidget *m);
+    void Unregister(MEBWidget *m);
+
+    /**
+     * @brief Has every widget let go of its sub-windows of w, before w is deleted.
+     *
+     */
+    void Release(WINDOW *w);
+
+    const std::vector<MEBWindow *> &GetWindows() { return windows; };
+    const std::vector<MEBWidget *> &GetWidgets() { return widgets; };
+
+private:
+    MEBScreen();
+
+    // FOR INTERNAL USE ONLY
+    void Flush();
+    void place_windows();
+    void compose();
+    void reset_damage(bool force);
+    bool row_hidden(size_t i, int sr, int x0, int x1);
+    void restack(MEBWindow *w, bool top);
+
+    int frame_depth;
+    MEBRenderer *renderer;
+    MEBShare *share;
+    MEBRecorder *recorder;
+    MEBLayout *layout;
+    int layout_cols; // Screen size the layout was last applied to.
+    int layout_rows;
+
+    std::vector<MEBWindow *> windows; // Bottom-most first.
+    std::vector<MEBWidget *> widgets;
+
+    // Per-screen-row span of columns which must be repainted, [lo, hi] inclusive. lo > hi means clean.
+    std::vector<int> damage_lo;
+    std::vector<int> damage_hi;
+
+    std::vector<std::pair<int, int> > cover; // Scratch for row_hidden(...).
+};
+
+/**
+ * @brief A bordered window.
+ *
+ * Windows form a hierarchy: a child is placed relative to its parent, and moves with it. Moving or resizing a window
+ * only marks its descendants as needing to be placed again; they are placed once, when the frame is output, however
+ * many times their ancestors moved in between. Children are stacked above their parent, and any rows of a window
+ * which are wholly hidden by windows above it are not staged for output at all. To follow the terminal's size, place
+ * windows with a MEBLayout.
+ *
+ */
 class MEBWindow
 {
 public:
+    /**
+     * @brief Enables or disables damage-tracked updates for all MEBWindows.
+     *
+     * When enabled, Move(...), MoveTo(...), Resize(...), ResizeTo(...) and Refresh() update the existing NCURSES window in place instead of destroying and recreating it. Only the screen cells which changed are marked dirty, and any area the window no longer covers is repaired from the windows beneath it (or stdscr) rather than blanked. Window contents are preserved across moves. Disabled by default.
+     *
+     * @param enable True to enable damage tracking.
+     */
+    static void SetDamageTracking(bool enable);
+
+    /**
+     * @brief Returns whether damage-tracked updates are enabled.
+     *
+     */
+    static bool DamageTracking();
+
     /**
      * @brief Spawns a MEBWindow; constructor.
      *
@@ -58,12 +342,12 @@ public:
      * @param cols Columns wide.
      * @param rows Rows tall.
      * @param title Title of the window (maximum 32 characters).
-     * @param parent (Optional) Pointer to the parent window.
+     * @param parent (Optional) Pointer to the parent window. The child is placed to its right, y rows below its top.
      */
     MEBWindow(int x, int y, int cols, int rows, const char *title, MEBWindow *parent = nullptr);
 
     /**
-     * @brief Frees window memory; destructor.
+     * @brief Frees window memory; destructor. Children are left where they are, without a parent.
      *
      */
     ~MEBWindow();
@@ -104,6 +388,16 @@ public:
      */
     void ResizeTo(int cols, int rows);
 
+    /**
+     * @brief Moves and resizes a MEBWindow at once, with a single refresh.
+     *
+     * @param x The x-axis positional coordinate.
+     * @param y The y-axis positional coordinate.
+     * @param cols Width to resize to.
+     * @param rows Height to resize to.
+     */
+    void Place(int x, int y, int cols, int rows);
+
     /**
      * @brief Refreshes a MEBWindow.
      *
@@ -111,8 +405,42 @@ public:
      */
     void Refresh();
 
+    /**
+     * @brief Copies the window's cells, frame included, into a cell grid sized to the window.
+     *
+     * @param out The grid.
+     */
+    void Snapshot(MEBCellBuffer &out);
+
+    /**
+     * @brief Raises the window, and its descendants, above all others.
+     *
+     */
+    void Raise() { MEBScreen::Get()->Raise(this); };
+
+    /**
+     * @brief Lowers the window, and its descendants, beneath all others.
+     *
+     */
+    void Lower() { MEBScreen::Get()->Lower(this); };
+
+    /**
+     * @brief Returns true if w is this window or one of its descendants.
+     *
+     */
+    bool Contains(MEBWindow *w);
+
+    /**
+     * @brief Returns true if an ancestor moved or resized since the window was last placed.
+     *
+     */
+    bool IsStale() { return stale; };
+
+    const std::vector<MEBWindow *> &GetChildren() { return children; };
+
     WINDOW *win;
     MEBWindow *parent;
+    MEBCounters counters;
 
     int X() { return x_; };
     int Y() { return y_; };
@@ -126,6 +454,15 @@ private:
     // FOR INTERNAL USE ONLY
     void instantiate_window();
     void destroy_window();
+    void delete_win();
+    void update_window();
+    void draw_frame();
+    void invalidate_children();
+    int screen_x();
+    int screen_y();
+
+    std::vector<MEBWindow *> children;
+    bool stale; // An ancestor moved or resized since the window was placed.
 
     int x_;
     int y_;
@@ -136,11 +473,26 @@ private:
     char title[MAX_WIN_TITLE];
 };
 
+/**
+ * @brief Supplies the title and description of a virtual MEBMenu's item.
+ *
+ * The strings need only remain valid until the source is called again.
+ *
+ * @param index Index of the item.
+ * @param title Set to the item's title.
+ * @param desc Set to the item's description (may be set to NULL).
+ */
+typedef std::function<void(int index, const char **title, const char **desc)> MEBMenuSource;
+
 /**
  * @brief The MEBMenu class, a wrapper around NCURSES' MENU.
  *
+ * A virtual MEBMenu is instead fed by an item count and a MEBMenuSource. It keeps no per-item state at all, and only
+ * the rows visible in its sub-window are ever fetched and drawn, so it handles millions of items with constant-time
+ * scrolling.
+ *
  */
-class MEBMenu
+class MEBMenu : public MEBWidget
 {
 public:
     /**
@@ -151,14 +503,28 @@ public:
      * @param y Parent window relative y-axis offset.
      * @param cols Width.
      * @param rows Height.
-     * @param n_items Number of items listed in the menu.
-     * @param item_titles List of strings to title each item.
-     * @param item_desc List of strings to describe each item.
+     * @param n_items Number of items listed in the menu; a NULL title ends the list early.
+     * @param item_titles List of strings to title each item. Copied; the caller keeps ownership.
+     * @param item_desc List of strings to describe each item. Copied; the caller keeps ownership.
      * @param mark The "You Are Here" indicator.
      * @return MEBMenu*
      */
     MEBMenu(MEBWindow *w, int x, int y, int cols, int rows, int n_items, char *item_titles[], char *item_desc[], const char *mark);
 
+    /**
+     * @brief Spawns a virtual menu; constructor.
+     *
+     * @param w Parent MEBWindow.
+     * @param x Parent window relative x-axis offset.
+     * @param y Parent window relative y-axis offset.
+     * @param cols Width.
+     * @param rows Height.
+     * @param n_items Number of items listed in the menu.
+     * @param source Called for each item as it scrolls into view.
+     * @param mark The "You Are Here" indicator.
+     */
+    MEBMenu(MEBWindow *w, int x, int y, int cols, int rows, int n_items, MEBMenuSource source, const char *mark);
+
     /**
      * @brief Moves the menu some delta-position.
      *
@@ -173,6 +539,20 @@ public:
      */
     void Refresh();
 
+    /**
+     * @brief Unposts the menu and deletes its sub-window if it was made from w, which its MEBWindow is about to delete.
+     *
+     */
+    void Release(WINDOW *w);
+
+    /**
+     * @brief Re-posts the menu if its parent window was recreated; called by MEBScreen once per frame.
+     *
+     */
+    void Render();
+
+    const char *Name() { return "menu"; };
+
     /**
      * @brief Destructor.
      *
@@ -180,18 +560,118 @@ public:
     ~MEBMenu();
 
     /**
-     * @brief Automatically handles up / down navigation, and returns the index of the choice selected or -1 if no selection was made.
-     * 
-     * @param in The user's input, retrieved via wgetch(...); 
+     * @brief Automatically handles up / down, page up / page down and home / end navigation, and returns the index of the choice selected or -1 if no selection was made.
+     *
+     * Navigation only moves a pending current item, which Render() applies once per frame; a burst of keys read in one
+     * frame, such as a held arrow key, is drawn as the single net movement rather than item by item.
+     *
+     * @param in The user's input, retrieved via wgetch(...);
      */
     int Update(int in);
 
+    /**
+     * @brief Makes an item current, scrolling it into view.
+     *
+     * @param index Index of the item; clamped to the valid range.
+     */
+    void JumpTo(int index);
+
+    /**
+     * @brief Changes the number of items in a virtual menu. Visible rows are fetched again from the source.
+     *
+     * @param n_items The new number of items.
+     */
+    void SetCount(int n_items);
+
+    /**
+     * @brief Inserts an item into a classic menu. The scroll position and current item are kept.
+     *
+     * @param index Position of the new item; GetCount() appends.
+     * @param title The item's title; must not be empty. Copied.
+     * @param desc The item's description. Copied.
+     */
+    void InsertItem(int index, const char *title, const char *desc);
+
+    /**
+     * @brief Appends an item to a classic menu.
+     *
+     */
+    void AppendItem(const char *title, const char *desc) { InsertItem(n_items, title, desc); };
+
+    /**
+     * @brief Removes an item from a classic menu. If it was current, the item that takes its place becomes current.
+     *
+     * @param index Position of the item.
+     */
+    void RemoveItem(int index);
+
+    /**
+     * @brief Replaces the text of an item of a classic menu in place.
+     *
+     * @param index Position of the item.
+     * @param title The new title; must not be empty. Copied.
+     * @param desc The new description. Copied.
+     */
+    void SetItem(int index, const char *title, const char *desc);
+
+    /**
+     * @brief Redraws one item of a virtual menu after its source changed, if it is visible.
+     *
+     * @param index Index of the item.
+     */
+    void InvalidateItem(int index);
+
+    /**
+     * @brief Sets the width of the title column of a virtual menu. Defaults to half the menu's width.
+     *
+     * @param title_cols Columns reserved for titles.
+     */
+    void SetTitleWidth(int title_cols);
+
+    /**
+     * @brief Returns the index of the current item, or -1 if the menu is empty.
+     *
+     */
+    int GetCurrent();
+
+    /**
+     * @brief Enables type-ahead filtering: printable keys passed to Update(...) narrow the menu to the items whose title or description contains the typed text (case-insensitive). Backspace removes a character and Escape clears the filter.
+     *
+     * The current filter is shown on the parent window's bottom border. Very large lists are searched in the background; set the index's OnProgress(...) callback to wake the UI thread so partial results are shown as they arrive.
+     *
+     * @param index (Optional) An index over this menu's items. Classic menus build their own when none is given, and keep it current as items are edited; virtual menus require one, which the caller must rebuild after editing.
+     */
+    void EnableTypeAhead(MEBSearchIndex *index = nullptr);
+
+    /**
+     * @brief Sets the filter text directly.
+     *
+     * @param text The text to filter by; empty to show every item.
+     */
+    void SetFilter(const char *text);
+
+    const char *GetFilter() { return filter.c_str(); };
+    MEBSearchIndex *GetFilterIndex() { return filter_index; };
+
+    int GetCount() { return n_items; };
+    bool IsVirtual() { return is_virtual; };
     MENU *GetMenu() { return menu; };
     MEBWindow *GetParent() { return parent; };
 
 private:
     void InstantiateMenu();
     void DestroyMenu();
+    void relink(ITEM **list, ITEM *keep, int keep_top);
+    void build_own_index();
+    void reindex();
+    void virtual_move(int delta);
+    void virtual_draw_row(int pos);
+    void navigate(int in);
+    void settle();
+    int view_count();
+    int view_item(int pos);
+    void sync_filter();
+    void draw_filter_prompt();
 
     int x;
     int y;
@@ -199,15 +679,46 @@ private:
     int cols;
     char mark[MAX_MENU_MARK];
     MENU *menu;
-    ITEM **items;
+    std::vector<ITEM *> items; // Classic menus only; NULL-terminated.
+    MEBArena strings;          // Item titles and descriptions of a classic menu.
     int n_items;
     MEBWindow *parent;
+    WINDOW *posted_win; // The parent's NCURSES window when the menu was last posted.
+    WINDOW *sub;
+
+    // Virtual menus only.
+    bool is_virtual;
+    MEBMenuSource source;
+    int top;         // Index of the first visible item.
+    int cur;         // Index of the current item.
+    int drawn_top;   // top and cur as of the last draw; -1 forces a full redraw.
+    int drawn_cur;
+    int title_cols;
+    std::vector<char> line; // One row of text.
+
+    // Classic menus only: movement folded from navigation keys, applied by settle(). nav_pos is -1 if none is pending.
+    int nav_pos;
+    int nav_top;
+
+    // Type-ahead filtering. top, cur, drawn_top and drawn_cur are positions among the filtered items while filtering.
+    MEBSearchIndex *filter_index;
+    bool own_index;
+    bool index_stale; // Items were edited since the owned index was built.
+    std::string filter;
+    std::string drawn_filter;
+    std::vector<int> filtered; // Item indices matching the filter, ascending.
+    uint64_t filtered_gen;
+    std::vector<ITEM *> filtered_items; // Classic menus only; NULL-terminated.
+    int prompt_len;
 };
 
 // TODO: Split declaration and definition of input(...).
 /**
  * @brief Method for taking input from the user.
  *
+ * Blocks the whole program, frames and event loop included, until Enter is pressed. Prefer a MEBInputField
+ * (meb_input.hpp), which edits a line as keys arrive from the event loop.
+ *
  * @param mwin MEBWindow the input is being taken in.
  * @param x The window relative x-coordinate to begin at.
  * @param y The window relative y-coordinate to begin at.
@@ -0,0 +1,307 @@
+/**
+ * @file meb_anim.cpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Frame-paced window animation, applying each window's geometry at most once per frame.
+ * @version See Git tags for version information.
+ * @date 2026.10.16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <ncurses.h>
+#include <menu.h>
+#include <math.h>
+#include <algorithm>
+#include <vector>
+
+#include "mebgui.hpp"
+#include "meb_anim.hpp"
+#include "meb_eventloop.hpp"
+#include "meb_stats.hpp"
+
+// FOR INTERNAL USE ONLY
+// Maps linear progress p, from 0 to 1, onto an easing curve.
+static double ease_progress(MEBEasing ease, double p)
+{
+    switch (ease)
+    {
+    case MEB_EASE_IN:
+        return p * p;
+    case MEB_EASE_OUT:
+        return 1 - (1 - p) * (1 - p);
+    case MEB_EASE_IN_OUT:
+        return p < 0.5 ? 2 * p * p : 1 - 2 * (1 - p) * (1 - p);
+    default:
+        return p;
+    }
+}
+
+// FOR INTERNAL USE ONLY
+static int lerp(int from, int to, double p)
+{
+    return from + (int)lround((to - from) * p);
+}
+
+// Creates the animator.
+MEBAnimator::MEBAnimator(int fps /* = MEB_ANIM_DEFAULT_FPS */)
+{
+    this->loop = nullptr;
+    this->timer = -1;
+    this->fps = 0;
+    this->interval_us = 0;
+    this->last_frame_us = 0;
+    this->requested = 0;
+    this->placed = 0;
+    this->skipped = 0;
+
+    SetFrameRate(fps);
+}
+
+// Removes the animator's timer.
+MEBAnimator::~MEBAnimator()
+{
+    disarm();
+}
+
+// Applies scheduled changes from a timer on the loop.
+void MEBAnimator::Attach(MEBEventLoop *loop)
+{
+    disarm();
+    this->loop = loop;
+
+    if (!tracks.empty())
+        arm();
+}
+
+// Changes the frame rate, re-arming the timer at the new interval.
+void MEBAnimator::SetFrameRate(int fps)
+{
+    fps = std::max(1, std::min(fps, 1000));
+    if (fps == this->fps)
+        return;
+
+    this->fps = fps;
+    this->interval_us = 1000000 / fps;
+
+    if (timer >= 0)
+    {
+        disarm();
+        arm();
+    }
+}
+
+// Moves a window by some delta from where it is scheduled to end up.
+void MEBAnimator::Move(MEBWindow *w, int dx, int dy)
+{
+    MEBRect r = Target(w);
+    r.x += dx;
+    r.y += dy;
+    schedule(w, r);
+}
+
+// Moves a window to a specific location.
+void MEBAnimator::MoveTo(MEBWindow *w, int x, int y)
+{
+    MEBRect r = Target(w);
+    r.x = x;
+    r.y = y;
+    schedule(w, r);
+}
+
+// Resizes a window by some delta from its scheduled size.
+void MEBAnimator::Resize(MEBWindow *w, int dcols, int drows)
+{
+    MEBRect r = Target(w);
+    r.cols += dcols;
+    r.rows += drows;
+    schedule(w, r);
+}
+
+// Resizes a window to a specific size.
+void MEBAnimator::ResizeTo(MEBWindow *w, int cols, int rows)
+{
+    MEBRect r = Target(w);
+    r.cols = cols;
+    r.rows = rows;
+    schedule(w, r);
+}
+
+// Moves and resizes a window gradually from where it is now to a target.
+void MEBAnimator::Animate(MEBWindow *w, const MEBRect &to, int duration_ms, MEBEasing ease /* = MEB_EASE_LINEAR */)
+{
+    requested++;
+
+    track *t = find(w);
+    if (t == nullptr)
+    {
+        tracks.push_back(track());
+        t = &tracks.back();
+    }
+
+    MEBRect from = {w->X(), w->Y(), w->Cols(), w->Rows()};
+    t->window = w;
+    t->from = from;
+    t->to = to;
+    t->start_us = MEBStats::Get()->Now();
+    t->duration_us = (uint64_t)std::max(duration_ms, 0) * 1000;
+    t->ease = ease;
+
+    arm();
+}
+
+// Drops a window's scheduled changes.
+void MEBAnimator::Cancel(MEBWindow *w)
+{
+    track *t = find(w);
+    if (t != nullptr)
+        tracks.erase(tracks.begin() + (t - tracks.data()));
+}
+
+// Returns true if a window has changes still to be applied.
+bool MEBAnimator::IsScheduled(MEBWindow *w)
+{
+    return find(w) != nullptr;
+}
+
+// Returns where a window is scheduled to end up.
+MEBRect MEBAnimator::Target(MEBWindow *w)
+{
+    track *t = find(w);
+    if (t != nullptr)
+        return t->to;
+
+    MEBRect r = {w->X(), w->Y(), w->Cols(), w->Rows()};
+    return r;
+}
+
+// Applies scheduled changes if a frame is due, all within one MEBScreen frame.
+int MEBAnimator::Tick(bool force /* = false */)
+{
+    if (tracks.empty())
+    {
+        disarm();
+        return 0;
+    }
+
+    uint64_t now = MEBStats::Get()->Now();
+    if (last_frame_us != 0)
+    {
+        // Timers only count whole milliseconds, so a frame arriving a little early is still due.
+        uint64_t elapsed = now - last_frame_us;
+        if (elapsed < interval_us - interval_us / 4 && !force)
+            return 0;
+
+        if (elapsed >= 2 * interval_us)
+            skipped += elapsed / interval_us - 1;
+    }
+    last_frame_us = now;
+
+    int n = 0;
+    MEBScreen::Get()->BeginFrame();
+    for (size_t i = 0; i < tracks.size();)
+    {
+        track &t = tracks[i];
+        MEBWindow *w = t.window;
+
+        bool done = t.duration_us == 0 || now - t.start_us >= t.duration_us;
+        MEBRect r = t.to;
+        if (!done)
+        {
+            double p = ease_progress(t.ease, (double)(now - t.start_us) / t.duration_us);
+            r.x = lerp(t.from.x, t.to.x, p);
+            r.y = lerp(t.from.y, t.to.y, p);
+            r.cols = lerp(t.from.cols, t.to.cols, p);
+            r.rows = lerp(t.from.rows, t.to.rows, p);
+        }
+
+        if (r.x != w->X() || r.y != w->Y() || r.cols != w->Cols() || r.rows != w->Rows())
+        {
+            w->Place(r.x, r.y, r.cols, r.rows);
+            placed++;
+            n++;
+        }
+
+        if (done)
+            tracks.erase(tracks.begin() + i);
+        else
+            i++;
+    }
+    MEBScreen::Get()->EndFrame();
+
+    if (tracks.empty())
+        disarm();
+
+    return n;
+}
+
+// FOR INTERNAL USE ONLY
+MEBAnimator::track *MEBAnimator::find(MEBWindow *w)
+{
+    for (size_t i = 0; i < tracks.size(); i++)
+    {
+        if (tracks[i].window == w)
+            return &tracks[i];
+    }
+    return nullptr;
+}
+
+// FOR INTERNAL USE ONLY
+// Sets where a window should end up. An animation in progress keeps going, towards the new target.
+void MEBAnimator::schedule(MEBWindow *w, const MEBRect &to)
+{
+    requested++;
+
+    track *t = find(w);
+    if (t == nullptr)
+    {
+        track nt;
+        nt.window = w;
+        nt.from = to;
+        nt.start_us = 0;
+        nt.duration_us = 0;
+        nt.ease = MEB_EASE_LINEAR;
+        tracks.push_back(nt);
+        t = &tracks.back();
+    }
+    t->to = to;
+
+    arm();
+}
+
+// FOR INTERNAL USE ONLY
+// Starts the frame timer, if attached and not already running.
+void MEBAnimator::arm()
+{
+    if (loop == nullptr || timer >= 0)
+        return;
+
+    timer = loop->AddTimer(std::max((int)(interval_us / 1000), 1), [this]()
+                           { Tick(); });
+}
+
+// FOR INTERNAL USE ONLY
+// Stops the frame timer. The next frame after an idle spell is not counted as late.
+void MEBAnimator::disarm()
+{
+    last_frame_us = 0;
+
+    if (loop == nullptr || timer < 0)
+        return;
+
+    loop->RemoveTimer(timer);
+    timer = -1;
+}
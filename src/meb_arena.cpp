@@ -0,0 +1,152 @@
+/**
+ * @file meb_arena.cpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief A string arena with size-class recycling, for per-widget text storage.
+ * @version See Git tags for version information.
+ * @date 2026.10.16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "meb_arena.hpp"
+
+#define MEB_ARENA_MIN_SHIFT 4 // Smallest class is 16 bytes.
+#define MEB_ARENA_LARGE -1
+
+// Creates an empty arena.
+MEBArena::MEBArena()
+{
+    cursor = nullptr;
+    large_list = nullptr;
+    remaining = 0;
+    footprint = 0;
+
+    int n_classes = 0;
+    for (size_t c = 1 << MEB_ARENA_MIN_SHIFT; c <= MEB_ARENA_MAX_CLASS; c <<= 1)
+        n_classes++;
+    free_lists.resize(n_classes);
+}
+
+// Frees every chunk and long string.
+MEBArena::~MEBArena()
+{
+    for (size_t i = 0; i < chunks.size(); i++)
+        free(chunks[i]);
+
+    while (large_list != nullptr)
+    {
+        large *next = large_list->next;
+        free(large_list);
+        large_list = next;
+    }
+}
+
+// Copies a string into the arena.
+char *MEBArena::Strdup(const char *str)
+{
+    if (str == NULL)
+        str = "";
+
+    size_t len = strlen(str) + 1;
+    size_t need = len + sizeof(header);
+    int cls = class_of(need);
+
+    header *h;
+    if (cls == MEB_ARENA_LARGE)
+    {
+        large *l = (large *)malloc(sizeof(large) + need);
+        if (l == NULL)
+            return NULL;
+        l->prev = nullptr;
+        l->next = large_list;
+        if (large_list != nullptr)
+            large_list->prev = l;
+        large_list = l;
+
+        h = (header *)(l + 1);
+        h->size_class = need;
+        footprint += sizeof(large) + need;
+    }
+    else if (!free_lists[cls].empty())
+    {
+        h = (header *)free_lists[cls].back();
+        free_lists[cls].pop_back();
+    }
+    else
+    {
+        size_t size = (size_t)1 << (cls + MEB_ARENA_MIN_SHIFT);
+        if (remaining < size)
+        {
+            // The tail of the old chunk is abandoned; at most one largest class per chunk.
+            cursor = (char *)malloc(MEB_ARENA_CHUNK);
+            if (cursor == NULL)
+                return NULL;
+            chunks.push_back(cursor);
+            remaining = MEB_ARENA_CHUNK;
+            footprint += MEB_ARENA_CHUNK;
+        }
+        h = (header *)cursor;
+        h->size_class = size;
+        cursor += size;
+        remaining -= size;
+    }
+
+    char *out = (char *)(h + 1);
+    memcpy(out, str, len);
+    return out;
+}
+
+// Returns a string to the arena for reuse.
+void MEBArena::Free(char *str)
+{
+    if (str == NULL)
+        return;
+
+    header *h = (header *)str - 1;
+    if (h->size_class > MEB_ARENA_MAX_CLASS)
+    {
+        large *l = (large *)h - 1;
+        if (l->prev != nullptr)
+            l->prev->next = l->next;
+        else
+            large_list = l->next;
+        if (l->next != nullptr)
+            l->next->prev = l->prev;
+
+        footprint -= sizeof(large) + h->size_class;
+        free(l);
+        return;
+    }
+
+    free_lists[class_of(h->size_class)].push_back((char *)h);
+}
+
+// FOR INTERNAL USE ONLY
+// Index of the smallest class holding bytes, or MEB_ARENA_LARGE.
+int MEBArena::class_of(size_t bytes)
+{
+    if (bytes > MEB_ARENA_MAX_CLASS)
+        return MEB_ARENA_LARGE;
+
+    int cls = 0;
+    while (((size_t)1 << (cls + MEB_ARENA_MIN_SHIFT)) < bytes)
+        cls++;
+    return cls;
+}
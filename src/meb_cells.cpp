@@ -0,0 +1,440 @@
+/**
+ * @file meb_cells.cpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief An in-memory grid of character cells which frames can be built in, snapshotted, diffed and dumped.
+ * @version See Git tags for version information.
+ * @date 2026.10.16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <ncurses.h>
+#include <menu.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "mebgui.hpp"
+#include "meb_cells.hpp"
+
+namespace
+{
+    // Translates a line-drawing cell for the terminal NCURSES is driving, keeping its other attributes.
+    inline chtype to_terminal(chtype ch)
+    {
+        if ((ch & A_ALTCHARSET) == 0)
+            return ch;
+
+        chtype acs = acs_map[ch & 0x7f];
+        if (acs == 0)
+            return ch;
+        return acs | (ch & (A_ATTRIBUTES & ~A_ALTCHARSET));
+    }
+
+#ifdef __SSE2__
+    // Cells compared per vector register.
+    const int simd_cells = sizeof(__m128i) / sizeof(chtype);
+
+    // Returns a bit per byte of the register, set where a and b differ.
+    inline unsigned simd_diff(const chtype *a, const chtype *b)
+    {
+        __m128i x = _mm_loadu_si128((const __m128i *)a);
+        __m128i y = _mm_loadu_si128((const __m128i *)b);
+        return ~_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)) & 0xffff;
+    }
+#endif
+
+    // Returns the index of the first cell of [0, n) that differs, or n.
+    int first_diff(const chtype *a, const chtype *b, int n)
+    {
+        int i = 0;
+#ifdef __SSE2__
+        for (; i + simd_cells <= n; i += simd_cells)
+        {
+            unsigned mask = simd_diff(a + i, b + i);
+            if (mask != 0)
+                return i + __builtin_ctz(mask) / sizeof(chtype);
+        }
+#endif
+        while (i < n && a[i] == b[i])
+            i++;
+        return i;
+    }
+
+    // Returns the index of the last cell of [0, n) that differs, or -1.
+    int last_diff(const chtype *a, const chtype *b, int n)
+    {
+        int i = n;
+#ifdef __SSE2__
+        for (; i - simd_cells >= 0; i -= simd_cells)
+        {
+            unsigned mask = simd_diff(a + i - simd_cells, b + i - simd_cells);
+            if (mask != 0)
+                return i - simd_cells + (31 - __builtin_clz(mask)) / sizeof(chtype);
+        }
+#endif
+        while (i > 0 && a[i - 1] == b[i - 1])
+            i--;
+        return i - 1;
+    }
+
+    char dump_char(chtype ch)
+    {
+        int c = ch & A_CHARTEXT;
+        if (ch & A_ALTCHARSET)
+        {
+            switch (c)
+            {
+            case 'q':
+                return '-';
+            case 'x':
+                return '|';
+            case 'l':
+            case 'k':
+            case 'm':
+            case 'j':
+            case 't':
+            case 'u':
+            case 'v':
+            case 'w':
+            case 'n':
+                return '+';
+            default:
+                return '#';
+            }
+        }
+        return (c >= 32 && c < 127) ? c : '?';
+    }
+
+    char dump_attr(chtype ch)
+    {
+        static const struct
+        {
+            attr_t attr;
+            char code;
+        } codes[] = {{A_REVERSE, 'R'}, {A_BOLD, 'B'}, {A_UNDERLINE, 'U'}, {A_STANDOUT, 'S'}, {A_DIM, 'D'}, {A_INVIS, 'I'}, {A_BLINK, 'K'}};
+
+        for (size_t i = 0; i < ARRAY_SIZE(codes); i++)
+        {
+            if (ch & codes[i].attr)
+                return codes[i].code;
+        }
+
+        int pair = PAIR_NUMBER(ch);
+        if (pair == 0)
+            return '.';
+        if (pair < 10)
+            return '0' + pair;
+        if (pair < 36)
+            return 'a' + pair - 10;
+        return '*';
+    }
+}
+
+// Creates a grid of blank cells.
+MEBCellBuffer::MEBCellBuffer(int cols /* = 0 */, int rows /* = 0 */)
+{
+    cols_ = 0;
+    rows_ = 0;
+    Resize(cols, rows);
+}
+
+// Resizes the grid, keeping the cells which still fit.
+void MEBCellBuffer::Resize(int cols, int rows)
+{
+    cols = std::max(cols, 0);
+    rows = std::max(rows, 0);
+    if (cols == cols_ && rows == rows_)
+        return;
+
+    std::vector<chtype> next((size_t)cols * rows, ' ');
+    int keep_cols = std::min(cols, cols_);
+    for (int r = 0; r < std::min(rows, rows_); r++)
+        std::copy(&cells[r * cols_], &cells[r * cols_] + keep_cols, &next[r * cols]);
+
+    cells.swap(next);
+    cols_ = cols;
+    rows_ = rows;
+}
+
+// Sets every cell.
+void MEBCellBuffer::Clear(chtype blank /* = ' ' */)
+{
+    std::fill(cells.begin(), cells.end(), blank);
+}
+
+// FOR INTERNAL USE ONLY
+// Clips a rectangle to the grid; returns false if nothing is left.
+bool MEBCellBuffer::clip(int *x, int *y, int *cols, int *rows) const
+{
+    int x0 = std::max(*x, 0);
+    int y0 = std::max(*y, 0);
+    int x1 = std::min(*x + *cols, cols_);
+    int y1 = std::min(*y + *rows, rows_);
+    if (x0 >= x1 || y0 >= y1)
+        return false;
+
+    *x = x0;
+    *y = y0;
+    *cols = x1 - x0;
+    *rows = y1 - y0;
+    return true;
+}
+
+// Sets a rectangle of cells.
+void MEBCellBuffer::Fill(int x, int y, int cols, int rows, chtype ch)
+{
+    if (!clip(&x, &y, &cols, &rows))
+        return;
+
+    for (int r = y; r < y + rows; r++)
+        std::fill(&cells[r * cols_ + x], &cells[r * cols_ + x] + cols, ch);
+}
+
+// Moves a band of whole rows up or down within itself.
+void MEBCellBuffer::ScrollRows(int top, int bottom, int n, chtype blank /* = ' ' */)
+{
+    top = std::max(top, 0);
+    bottom = std::min(bottom, rows_ - 1);
+    int span = bottom - top + 1;
+    if (span <= 0 || n == 0)
+        return;
+    if (abs(n) >= span)
+    {
+        Fill(0, top, cols_, span, blank);
+        return;
+    }
+
+    chtype *first = &cells[(size_t)top * cols_];
+    chtype *last = &cells[(size_t)(bottom + 1) * cols_];
+    size_t shift = (size_t)abs(n) * cols_;
+    if (n > 0)
+    {
+        std::copy(first + shift, last, first);
+        std::fill(last - shift, last, blank);
+    }
+    else
+    {
+        std::copy_backward(first, last - shift, last);
+        std::fill(first, first + shift, blank);
+    }
+}
+
+// Writes text along one row.
+int MEBCellBuffer::Print(int x, int y, const char *text, attr_t attr /* = A_NORMAL */)
+{
+    if (y < 0 || y >= rows_)
+        return x + strlen(text);
+
+    chtype *row = &cells[y * cols_];
+    for (; *text != '\0'; text++, x++)
+    {
+        if (x < 0 || x >= cols_)
+            continue;
+
+        unsigned char c = *text;
+        row[x] = ((c < 32 || c == 127) ? '?' : c) | attr;
+    }
+    return x;
+}
+
+// Formats text and writes it along one row.
+int MEBCellBuffer::Printf(int x, int y, attr_t attr, const char *fmt, ...)
+{
+    char buf[512];
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+
+    return Print(x, y, buf, attr);
+}
+
+void MEBCellBuffer::HLine(int x, int y, int cols, chtype ch /* = MEB_CELL_HLINE */)
+{
+    Fill(x, y, cols, 1, ch);
+}
+
+void MEBCellBuffer::VLine(int x, int y, int rows, chtype ch /* = MEB_CELL_VLINE */)
+{
+    Fill(x, y, 1, rows, ch);
+}
+
+// Draws a border just inside the given rectangle.
+void MEBCellBuffer::Box(int x, int y, int cols, int rows)
+{
+    if (cols < 2 || rows < 2)
+        return;
+
+    HLine(x + 1, y, cols - 2);
+    HLine(x + 1, y + rows - 1, cols - 2);
+    VLine(x, y + 1, rows - 2);
+    VLine(x + cols - 1, y + 1, rows - 2);
+    Put(x, y, MEB_CELL_ULCORNER);
+    Put(x + cols - 1, y, MEB_CELL_URCORNER);
+    Put(x, y + rows - 1, MEB_CELL_LLCORNER);
+    Put(x + cols - 1, y + rows - 1, MEB_CELL_LRCORNER);
+}
+
+// Copies another grid into this one.
+void MEBCellBuffer::Blit(const MEBCellBuffer &src, int x, int y)
+{
+    int dx = x, dy = y, cols = src.cols_, rows = src.rows_;
+    if (!clip(&dx, &dy, &cols, &rows))
+        return;
+
+    int sx = dx - x, sy = dy - y;
+    for (int r = 0; r < rows; r++)
+    {
+        const chtype *from = &src.cells[(sy + r) * src.cols_ + sx];
+        std::copy(from, from + cols, &cells[(dy + r) * cols_ + dx]);
+    }
+}
+
+// Copies the cells of an NCURSES window into this grid.
+void MEBCellBuffer::Capture(WINDOW *w, int x, int y)
+{
+    int wrows, wcols;
+    getmaxyx(w, wrows, wcols);
+
+    int dx = x, dy = y, cols = wcols, rows = wrows;
+    if (!clip(&dx, &dy, &cols, &rows))
+        return;
+
+    int cy, cx;
+    getyx(w, cy, cx);
+
+    // winchnstr(...) terminates what it reads, so it needs a spare cell.
+    std::vector<chtype> line(cols + 1);
+    for (int r = 0; r < rows; r++)
+    {
+        int n = mvwinchnstr(w, dy - y + r, dx - x, &line[0], cols);
+        if (n == ERR)
+            continue;
+        std::copy(&line[0], &line[0] + n, &cells[(dy + r) * cols_ + dx]);
+    }
+
+    wmove(w, cy, cx);
+}
+
+// Stages the grid into an NCURSES window, only where it differs from prev if given.
+void MEBCellBuffer::Draw(WINDOW *w, int x, int y, const MEBCellBuffer *prev /* = nullptr */) const
+{
+    int wrows, wcols;
+    getmaxyx(w, wrows, wcols);
+
+    if (prev != nullptr && (prev->cols_ != cols_ || prev->rows_ != rows_))
+        prev = nullptr;
+
+    std::vector<chtype> line(cols_);
+    for (int r = 0; r < rows_; r++)
+    {
+        int wy = y + r;
+        if (wy < 0 || wy >= wrows)
+            continue;
+
+        int lo = 0, hi = cols_ - 1;
+        if (prev != nullptr && !DiffRow(*prev, r, &lo, &hi))
+            continue;
+
+        lo = std::max(lo, -x);
+        hi = std::min(hi, wcols - 1 - x);
+        if (lo > hi)
+            continue;
+
+        const chtype *row = &cells[r * cols_];
+        for (int c = lo; c <= hi; c++)
+            line[c] = to_terminal(row[c]);
+        mvwaddchnstr(w, wy, x + lo, &line[lo], hi - lo + 1);
+    }
+}
+
+// Finds the span of one row that differs from another grid of the same size.
+bool MEBCellBuffer::DiffRow(const MEBCellBuffer &prev, int row, int *lo, int *hi) const
+{
+    const chtype *a = &cells[row * cols_];
+    const chtype *b = &prev.cells[row * cols_];
+
+    int l = first_diff(a, b, cols_);
+    if (l == cols_)
+        return false;
+
+    *lo = l;
+    *hi = last_diff(a + l, b + l, cols_ - l) + l;
+    return true;
+}
+
+// Lists the differing span of every row that differs from another grid.
+int MEBCellBuffer::Diff(const MEBCellBuffer &prev, std::vector<MEBRect> &spans) const
+{
+    spans.clear();
+    bool same_size = prev.cols_ == cols_ && prev.rows_ == rows_;
+
+    for (int r = 0; r < rows_ && cols_ > 0; r++)
+    {
+        int lo = 0, hi = cols_ - 1;
+        if (same_size && !DiffRow(prev, r, &lo, &hi))
+            continue;
+
+        MEBRect span = {lo, r, hi - lo + 1, 1};
+        spans.push_back(span);
+    }
+    return spans.size();
+}
+
+// Writes the grid as text, one line per row.
+void MEBCellBuffer::Dump(FILE *fp, bool attrs /* = false */) const
+{
+    std::vector<char> line(cols_ + 1);
+    for (int r = 0; r < rows_; r++)
+    {
+        const chtype *row = &cells[r * cols_];
+        for (int c = 0; c < cols_; c++)
+            line[c] = dump_char(row[c]);
+        line[cols_] = '\0';
+        fputs(&line[0], fp);
+
+        if (attrs)
+        {
+            for (int c = 0; c < cols_; c++)
+                line[c] = dump_attr(row[c]);
+            fputc('\t', fp);
+            fputs(&line[0], fp);
+        }
+        fputc('\n', fp);
+    }
+}
+
+// Exchanges the contents of two grids.
+void MEBCellBuffer::Swap(MEBCellBuffer &other)
+{
+    std::swap(cols_, other.cols_);
+    std::swap(rows_, other.rows_);
+    cells.swap(other.cells);
+}
+
+bool MEBCellBuffer::operator==(const MEBCellBuffer &other) const
+{
+    return cols_ == other.cols_ && rows_ == other.rows_ && cells == other.cells;
+}
@@ -0,0 +1,342 @@
+/**
+ * @file meb_eventloop.cpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief An epoll-driven event loop for mebgui programs.
+ * @version See Git tags for version information.
+ * @date 2026.10.16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <ncurses.h>
+#include <menu.h>
+#include <errno.h>
+#include <signal.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
+#include <stdexcept>
+
+#include "mebgui.hpp"
+#include "meb_eventloop.hpp"
+#include "meb_record.hpp"
+#include "meb_render.hpp"
+#include "meb_stats.hpp"
+
+#define MEB_EVENTLOOP_MAX_EVENTS 16
+
+// Creates the loop.
+MEBEventLoop::MEBEventLoop()
+{
+    running = false;
+
+    sigset_t mask;
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGWINCH);
+    sigaddset(&mask, SIGINT);
+    sigaddset(&mask, SIGTERM);
+
+    // The signals must be blocked for signalfd to receive them; this also keeps NCURSES' own SIGWINCH handler quiet.
+    pthread_sigmask(SIG_BLOCK, &mask, &old_mask);
+
+    epfd = epoll_create1(EPOLL_CLOEXEC);
+    sigfd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+    evfd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+    if (epfd < 0 || sigfd < 0 || evfd < 0)
+        throw std::runtime_error("Could not create event loop descriptors.");
+
+    add_source(STDIN_FILENO, SRC_INPUT);
+    add_source(sigfd, SRC_SIGNAL);
+    add_source(evfd, SRC_WAKEUP);
+
+    // Input is only read once epoll reports it, so wgetch(...) must never wait.
+    wtimeout(stdscr, 0);
+
+    quit_cb = [this](int sig)
+    { Stop(); };
+}
+
+// Closes all descriptors and restores the signal mask.
+MEBEventLoop::~MEBEventLoop()
+{
+    for (std::map<int, source>::iterator it = sources.begin(); it != sources.end(); it++)
+    {
+        if (it->second.type == SRC_TIMER)
+            close(it->first);
+    }
+
+    close(evfd);
+    close(sigfd);
+    close(epfd);
+
+    pthread_sigmask(SIG_SETMASK, &old_mask, NULL);
+}
+
+void MEBEventLoop::OnKey(std::function<void(int)> cb)
+{
+    key_cb = cb;
+}
+
+void MEBEventLoop::OnResize(std::function<void(int, int)> cb)
+{
+    resize_cb = cb;
+}
+
+void MEBEventLoop::OnQuit(std::function<void(int)> cb)
+{
+    quit_cb = cb;
+}
+
+void MEBEventLoop::OnWakeup(std::function<void()> cb)
+{
+    wakeup_cb = cb;
+}
+
+// Adds a timer.
+int MEBEventLoop::AddTimer(int interval_ms, std::function<void()> cb, bool repeat /* = true */)
+{
+    int tfd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (tfd < 0)
+        return -1;
+
+    struct itimerspec its;
+    memset(&its, 0, sizeof(its));
+    its.it_value.tv_sec = interval_ms / 1000;
+    its.it_value.tv_nsec = (interval_ms % 1000) * 1000000L;
+    if (its.it_value.tv_sec == 0 && its.it_value.tv_nsec == 0)
+        its.it_value.tv_nsec = 1; // A zero it_value would disarm the timer.
+    if (repeat)
+        its.it_interval = its.it_value;
+
+    if (timerfd_settime(tfd, 0, &its, NULL) < 0)
+    {
+        close(tfd);
+        return -1;
+    }
+
+    add_source(tfd, SRC_TIMER);
+    sources[tfd].repeat = repeat;
+    sources[tfd].timer_cb = cb;
+
+    return tfd;
+}
+
+// Removes a timer.
+void MEBEventLoop::RemoveTimer(int id)
+{
+    std::map<int, source>::iterator it = sources.find(id);
+    if (it == sources.end() || it->second.type != SRC_TIMER)
+        return;
+
+    epoll_ctl(epfd, EPOLL_CTL_DEL, id, NULL);
+    sources.erase(it);
+    close(id);
+}
+
+// Watches an arbitrary file descriptor for readability.
+int MEBEventLoop::Watch(int fd, std::function<void(int)> cb)
+{
+    if (sources.count(fd))
+        return -1;
+
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.fd = fd;
+    if (epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev) < 0)
+        return -1;
+
+    sources[fd].type = SRC_FD;
+    sources[fd].repeat = true;
+    sources[fd].fd_cb = cb;
+
+    return 0;
+}
+
+// Stops watching a file descriptor.
+void MEBEventLoop::Unwatch(int fd)
+{
+    std::map<int, source>::iterator it = sources.find(fd);
+    if (it == sources.end() || it->second.type != SRC_FD)
+        return;
+
+    epoll_ctl(epfd, EPOLL_CTL_DEL, fd, NULL);
+    sources.erase(it);
+}
+
+// Wakes the loop from any thread.
+void MEBEventLoop::Wakeup()
+{
+    uint64_t one = 1;
+    ssize_t rc = write(evfd, &one, sizeof(one));
+    (void)rc; // EAGAIN only means a wake-up is already pending.
+}
+
+// Runs until Stop() is called.
+void MEBEventLoop::Run()
+{
+    running = true;
+    while (running)
+    {
+        if (RunOnce(-1) < 0)
+            break;
+    }
+    running = false;
+}
+
+// Makes Run() return.
+void MEBEventLoop::Stop()
+{
+    running = false;
+    Wakeup();
+}
+
+// Waits for and handles one batch of events.
+int MEBEventLoop::RunOnce(int timeout_ms /* = -1 */)
+{
+    struct epoll_event events[MEB_EVENTLOOP_MAX_EVENTS];
+
+    // A dropped frame must still be output once the terminal catches up, even if nothing else happens by then.
+    MEBRenderer *r = MEBScreen::Get()->GetRenderer();
+    if (r != nullptr && r->Behind())
+    {
+        int retry = r->RetryMs();
+        if (timeout_ms < 0 || retry < timeout_ms)
+            timeout_ms = retry;
+    }
+
+    int n = epoll_wait(epfd, events, MEB_EVENTLOOP_MAX_EVENTS, timeout_ms);
+    if (n < 0)
+        return (errno == EINTR) ? 0 : -1;
+
+    MEBScreen::Get()->BeginFrame();
+
+    for (int i = 0; i < n; i++)
+    {
+        int fd = events[i].data.fd;
+
+        // An earlier callback in this batch may have removed the source.
+        std::map<int, source>::iterator it = sources.find(fd);
+        if (it == sources.end())
+            continue;
+
+        switch (it->second.type)
+        {
+        case SRC_INPUT:
+            handle_input();
+            break;
+        case SRC_SIGNAL:
+            handle_signal();
+            break;
+        case SRC_WAKEUP:
+        {
+            uint64_t count;
+            while (read(evfd, &count, sizeof(count)) > 0)
+                ;
+            if (wakeup_cb)
+                wakeup_cb();
+            break;
+        }
+        case SRC_TIMER:
+        {
+            uint64_t expirations;
+            if (read(fd, &expirations, sizeof(expirations)) <= 0)
+                break;
+
+            // Missed expirations are folded into a single call, so a busy loop never queues up timer work.
+            std::function<void()> cb = it->second.timer_cb;
+            if (!it->second.repeat)
+                RemoveTimer(fd);
+            if (cb)
+                cb();
+            break;
+        }
+        case SRC_FD:
+        {
+            std::function<void(int)> cb = it->second.fd_cb;
+            if (cb)
+                cb(fd);
+            break;
+        }
+        }
+    }
+
+    MEBScreen::Get()->EndFrame();
+
+    return n;
+}
+
+// FOR INTERNAL USE ONLY
+void MEBEventLoop::add_source(int fd, source_type type)
+{
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.fd = fd;
+    epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev);
+
+    sources[fd].type = type;
+    sources[fd].repeat = true;
+}
+
+// FOR INTERNAL USE ONLY
+// Delivers every key NCURSES can decode from what is currently buffered.
+void MEBEventLoop::handle_input()
+{
+    int in;
+    while ((in = wgetch(stdscr)) != ERR)
+    {
+        MEBStats::Get()->InputArrived();
+        // Fetched for every key, since a key's callback may stop the recording.
+        MEBRecorder *recorder = MEBScreen::Get()->GetRecorder();
+        if (recorder != nullptr)
+            recorder->Key(in);
+        if (key_cb)
+            key_cb(in);
+    }
+}
+
+// FOR INTERNAL USE ONLY
+void MEBEventLoop::handle_signal()
+{
+    struct signalfd_siginfo si;
+    while (read(sigfd, &si, sizeof(si)) == sizeof(si))
+    {
+        if (si.ssi_signo == SIGWINCH)
+        {
+            struct winsize ws;
+            if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) == 0)
+            {
+                // resizeterm(...) also queues KEY_RESIZE, which handle_input() passes on.
+                resizeterm(ws.ws_row, ws.ws_col);
+                if (resize_cb)
+                    resize_cb(ws.ws_col, ws.ws_row);
+                handle_input();
+            }
+        }
+        else if (quit_cb)
+        {
+            quit_cb(si.ssi_signo);
+        }
+    }
+}
@@ -0,0 +1,378 @@
+/**
+ * @file meb_input.cpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief A single-line text entry field fed from the event loop's keystrokes.
+ * @version See Git tags for version information.
+ * @date 2026.10.16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <ncurses.h>
+#include <menu.h>
+#include <ctype.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <stdexcept>
+
+#include "mebgui.hpp"
+#include "meb_input.hpp"
+
+#define CTRL_KEY(c) ((c) & 0x1f)
+
+// Spawns an input field.
+MEBInputField::MEBInputField(MEBWindow *w, int x, int y, int cols, const char *prompt /* = nullptr */, int max_len /* = MEB_INPUT_DEFAULT_MAX */, int history /* = MEB_INPUT_DEFAULT_HISTORY */)
+{
+    if (max_len < 1)
+        throw std::invalid_argument("Input must hold at least one character.");
+    if (prompt != nullptr && (int)strlen(prompt) >= cols)
+        throw std::length_error("Prompt leaves no room for input.");
+
+    this->x = x;
+    this->y = y;
+    this->cols = cols;
+    this->parent = w;
+    this->posted_win = nullptr;
+    this->sub = nullptr;
+
+    this->prompt = prompt != nullptr ? prompt : "";
+    this->max_len = max_len;
+    this->text.reserve(max_len); // Never reallocated while typing.
+    this->cursor = 0;
+    this->scroll = 0;
+    this->focused = false;
+    this->redraw = true;
+
+    this->history_max = std::max(history, 0);
+    this->recalled = -1;
+
+    Refresh();
+
+    MEBScreen::Get()->Register(this);
+}
+
+// Destructor.
+MEBInputField::~MEBInputField()
+{
+    MEBScreen::Get()->Unregister(this);
+
+    if (sub != nullptr)
+    {
+        werase(sub);
+        wsyncup(sub);
+        delwin(sub);
+    }
+    MEBScreen::Get()->Present();
+}
+
+// Sets the callback for Enter.
+void MEBInputField::OnSubmit(std::function<void(const char *)> cb)
+{
+    submit_cb = cb;
+}
+
+// Sets the callback for Escape.
+void MEBInputField::OnCancel(std::function<void()> cb)
+{
+    cancel_cb = cb;
+}
+
+// Gives or takes away the keyboard.
+void MEBInputField::Focus(bool focus)
+{
+    if (focus == focused)
+        return;
+
+    focused = focus;
+    changed();
+}
+
+// Edits the line with a key.
+bool MEBInputField::Update(int in)
+{
+    if (!focused)
+        return false;
+
+    int len = text.size();
+    switch (in)
+    {
+    case KEY_LEFT:
+        cursor = std::max(cursor - 1, 0);
+        break;
+    case KEY_RIGHT:
+        cursor = std::min(cursor + 1, len);
+        break;
+    case KEY_HOME:
+    case CTRL_KEY('a'):
+        cursor = 0;
+        break;
+    case KEY_END:
+    case CTRL_KEY('e'):
+        cursor = len;
+        break;
+    case KEY_BACKSPACE:
+    case 127:
+    case '\b':
+        erase(cursor - 1, cursor);
+        break;
+    case KEY_DC:
+        erase(cursor, cursor + 1);
+        break;
+    case CTRL_KEY('u'):
+        erase(0, cursor);
+        break;
+    case CTRL_KEY('k'):
+        erase(cursor, len);
+        break;
+    case CTRL_KEY('w'):
+    {
+        int from = cursor;
+        while (from > 0 && text[from - 1] == ' ')
+            from--;
+        while (from > 0 && text[from - 1] != ' ')
+            from--;
+        erase(from, cursor);
+        break;
+    }
+    case KEY_UP:
+        recall(-1);
+        break;
+    case KEY_DOWN:
+        recall(1);
+        break;
+    case '\n':
+    case '\r':
+    case KEY_ENTER:
+        submit();
+        return true;
+    case 27:
+        text.clear();
+        cursor = scroll = 0;
+        recalled = -1;
+        focused = false;
+        changed();
+        if (cancel_cb)
+            cancel_cb();
+        return true;
+    default:
+        if (in < ' ' || in >= 127)
+            return false;
+        insert((char)in);
+        return true;
+    }
+
+    changed();
+    return true;
+}
+
+// Draws the field if it changed since the last frame.
+void MEBInputField::Render()
+{
+    if (parent->win != nullptr && posted_win != parent->win)
+        Refresh();
+    if (sub == nullptr || !redraw)
+        return;
+    redraw = false;
+
+    // Keep the cursor in view, with room after it to show where the next character goes.
+    int room = cols - (int)prompt.size() - 1;
+    if (cursor < scroll)
+        scroll = cursor;
+    else if (cursor > scroll + room)
+        scroll = cursor - room;
+    scroll = std::max(std::min(scroll, (int)text.size() - room), 0);
+
+    werase(sub);
+    mvwaddnstr(sub, 0, 0, prompt.c_str(), prompt.size());
+    waddnstr(sub, text.c_str() + scroll, std::min((int)text.size() - scroll, room + 1));
+
+    if (focused)
+    {
+        // Drawn rather than left to the terminal's cursor, which belongs to whichever window was output last.
+        int cx = prompt.size() + cursor - scroll;
+        chtype c = cursor < (int)text.size() ? (unsigned char)text[cursor] : ' ';
+        mvwaddch(sub, 0, cx, c | A_REVERSE);
+    }
+
+    // The sub-window shares the parent's cells, but the parent must be told which of its lines changed.
+    wsyncup(sub);
+}
+
+// Replaces the line.
+void MEBInputField::SetText(const char *text)
+{
+    this->text.assign(text, strnlen(text, max_len));
+    cursor = this->text.size();
+    recalled = -1;
+    changed();
+}
+
+// Parses the last submitted line as a whole integer.
+bool MEBInputField::ParseInt(long *out, int base /* = 10 */)
+{
+    const char *s = submitted.c_str();
+    char *end;
+    errno = 0;
+    long v = strtol(s, &end, base);
+    if (end == s || errno == ERANGE)
+        return false;
+
+    while (isspace((unsigned char)*end))
+        end++;
+    if (*end != '\0')
+        return false;
+
+    *out = v;
+    return true;
+}
+
+// Parses the last submitted line as a whole floating-point number.
+bool MEBInputField::ParseDouble(double *out)
+{
+    const char *s = submitted.c_str();
+    char *end;
+    errno = 0;
+    double v = strtod(s, &end);
+    if (end == s || errno == ERANGE)
+        return false;
+
+    while (isspace((unsigned char)*end))
+        end++;
+    if (*end != '\0')
+        return false;
+
+    *out = v;
+    return true;
+}
+
+// Moves the field some delta-position.
+void MEBInputField::Move(int dx, int dy)
+{
+    counters.moves++;
+    x += dx;
+    y += dy;
+
+    Refresh();
+}
+
+// Recreates the field's sub-window and redraws it.
+void MEBInputField::Refresh()
+{
+    if (sub != nullptr)
+    {
+        werase(sub);
+        delwin(sub);
+        sub = nullptr;
+    }
+
+    posted_win = parent->win;
+    if (parent->win != nullptr)
+        sub = derwin(parent->win, 1, cols, y, x);
+
+    changed();
+}
+
+// Deletes the sub-window if it was made from w.
+void MEBInputField::Release(WINDOW *w)
+{
+    if (sub == nullptr || posted_win != w)
+        return;
+
+    delwin(sub);
+    sub = nullptr;
+    posted_win = nullptr;
+}
+
+// FOR INTERNAL USE ONLY
+void MEBInputField::insert(char c)
+{
+    if ((int)text.size() >= max_len)
+    {
+        beep();
+        return;
+    }
+
+    text.insert(cursor, 1, c);
+    cursor++;
+    changed();
+}
+
+// FOR INTERNAL USE ONLY
+// Deletes characters [from, to), clipped to the line.
+void MEBInputField::erase(int from, int to)
+{
+    from = std::max(from, 0);
+    to = std::min(to, (int)text.size());
+    if (from >= to)
+        return;
+
+    text.erase(from, to - from);
+    if (cursor > to)
+        cursor -= to - from;
+    else if (cursor > from)
+        cursor = from;
+}
+
+// FOR INTERNAL USE ONLY
+// Steps through the history; stepping past the newest entry returns to the line being edited.
+void MEBInputField::recall(int delta)
+{
+    int n = history.size();
+    int at = recalled < 0 ? n : recalled;
+    int next = std::max(std::min(at + delta, n), 0);
+    if (next == at)
+        return;
+
+    if (recalled < 0)
+        pending = text;
+
+    const std::string &s = next == n ? pending : history[next];
+    text.assign(s, 0, max_len);
+    cursor = text.size();
+    recalled = next == n ? -1 : next;
+}
+
+// FOR INTERNAL USE ONLY
+void MEBInputField::submit()
+{
+    submitted = text;
+
+    if (history_max > 0 && !text.empty() && (history.empty() || history.back() != text))
+    {
+        history.push_back(text);
+        if ((int)history.size() > history_max)
+            history.pop_front();
+    }
+
+    text.clear();
+    cursor = scroll = 0;
+    recalled = -1;
+    changed();
+
+    if (submit_cb)
+        submit_cb(submitted.c_str());
+}
+
+// FOR INTERNAL USE ONLY
+// Redraws the field with the next frame.
+void MEBInputField::changed()
+{
+    redraw = true;
+    MEBScreen::Get()->Present();
+}
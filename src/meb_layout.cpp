@@ -0,0 +1,277 @@
+/**
+ * @file meb_layout.cpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Constraint layout for MEBWindows, reapplied when the terminal is resized.
+ * @version See Git tags for version information.
+ * @date 2026.10.16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <ncurses.h>
+#include <menu.h>
+#include <algorithm>
+#include <vector>
+
+#include "mebgui.hpp"
+#include "meb_layout.hpp"
+
+// Creates a root split.
+MEBLayout::MEBLayout(MEBLayoutDirection dir)
+{
+    this->parent = nullptr;
+    this->dir = dir;
+    this->window = nullptr;
+    this->is_split = true;
+    this->constraint = MEBConstraint::Flex();
+    this->gap = 0;
+    this->rect = MEBRect();
+    this->applied = false;
+    this->dirty = true;
+    this->child_dirty = false;
+}
+
+// FOR INTERNAL USE ONLY
+MEBLayout::MEBLayout(MEBLayout *parent, MEBLayoutDirection dir, MEBWindow *w, MEBConstraint c)
+{
+    this->parent = parent;
+    this->dir = dir;
+    this->window = w;
+    this->is_split = false;
+    this->constraint = c;
+    this->gap = 0;
+    this->rect = MEBRect();
+    this->applied = false;
+    this->dirty = true;
+    this->child_dirty = false;
+}
+
+// Deletes the node and every node beneath it.
+MEBLayout::~MEBLayout()
+{
+    for (size_t i = 0; i < children.size(); i++)
+        delete children[i];
+}
+
+// Adds a split beneath this one.
+MEBLayout *MEBLayout::AddSplit(MEBLayoutDirection dir, MEBConstraint c)
+{
+    MEBLayout *child = new MEBLayout(this, dir, nullptr, c);
+    child->is_split = true;
+    return add(child);
+}
+
+// Adds a window beneath this split.
+MEBLayout *MEBLayout::AddWindow(MEBWindow *w, MEBConstraint c)
+{
+    return add(new MEBLayout(this, dir, w, c));
+}
+
+// Adds empty space beneath this split.
+MEBLayout *MEBLayout::AddSpace(MEBConstraint c)
+{
+    return add(new MEBLayout(this, dir, nullptr, c));
+}
+
+// Removes and deletes a node beneath this split.
+void MEBLayout::Remove(MEBLayout *child)
+{
+    std::vector<MEBLayout *>::iterator it = std::find(children.begin(), children.end(), child);
+    if (it == children.end())
+        return;
+
+    children.erase(it);
+    delete child;
+    mark_dirty();
+}
+
+// Changes the node's size.
+void MEBLayout::SetConstraint(MEBConstraint c)
+{
+    if (c == constraint)
+        return;
+
+    constraint = c;
+    if (parent != nullptr)
+        parent->mark_dirty();
+}
+
+// Sets the cells left between the children of this split.
+void MEBLayout::SetGap(int cells)
+{
+    if (cells == gap)
+        return;
+
+    gap = std::max(cells, 0);
+    mark_dirty();
+}
+
+// Lays the tree out within a rectangle, doing only the work that changed since the last call.
+int MEBLayout::Apply(const MEBRect &r)
+{
+    bool moved = !applied || r.x != rect.x || r.y != rect.y || r.cols != rect.cols || r.rows != rect.rows;
+    if (!moved && !dirty && !child_dirty)
+        return 0;
+
+    rect = r;
+    applied = true;
+    int placed = 0;
+
+    if (window != nullptr)
+    {
+        // Kept on the screen however little room is left, since NCURSES cannot place a window past its edge.
+        int cols = std::max(r.cols, 1);
+        int rows = std::max(r.rows, 1);
+        int x = std::max(std::min(r.x, COLS - cols), 0);
+        int y = std::max(std::min(r.y, LINES - rows), 0);
+
+        if (x != window->X() || y != window->Y() || cols != window->Cols() || rows != window->Rows())
+        {
+            window->Place(x, y, cols, rows);
+            placed++;
+        }
+    }
+    else if (is_split && (moved || dirty))
+    {
+        int n = children.size();
+        int along = dir == MEB_LAYOUT_ROW ? r.cols : r.rows;
+
+        std::vector<int> sizes;
+        distribute(std::max(along - gap * std::max(n - 1, 0), 0), sizes);
+
+        int pos = dir == MEB_LAYOUT_ROW ? r.x : r.y;
+        for (int i = 0; i < n; i++)
+        {
+            MEBRect cr = r;
+            if (dir == MEB_LAYOUT_ROW)
+            {
+                cr.x = pos;
+                cr.cols = sizes[i];
+            }
+            else
+            {
+                cr.y = pos;
+                cr.rows = sizes[i];
+            }
+            placed += children[i]->Apply(cr);
+            pos += sizes[i] + gap;
+        }
+    }
+    else if (is_split)
+    {
+        // Only something beneath changed; every other child keeps its place.
+        for (size_t i = 0; i < children.size(); i++)
+        {
+            if (children[i]->NeedsApply())
+                placed += children[i]->Apply(children[i]->rect);
+        }
+    }
+
+    dirty = false;
+    child_dirty = false;
+    return placed;
+}
+
+// FOR INTERNAL USE ONLY
+MEBLayout *MEBLayout::add(MEBLayout *child)
+{
+    children.push_back(child);
+    mark_dirty();
+    return child;
+}
+
+// FOR INTERNAL USE ONLY
+// Marks this split's children for redistribution, and the path to it for a visit.
+void MEBLayout::mark_dirty()
+{
+    dirty = true;
+    for (MEBLayout *p = parent; p != nullptr && !p->child_dirty; p = p->parent)
+        p->child_dirty = true;
+
+    MEBScreen::Get()->Present();
+}
+
+// FOR INTERNAL USE ONLY
+// Shares length cells among the children: fixed and percentage sizes first, then what is left over among the flexible
+// children by weight. If even the minimums do not fit, the last children are shrunk first.
+void MEBLayout::distribute(int length, std::vector<int> &sizes)
+{
+    int n = children.size();
+    sizes.assign(n, 0);
+
+    int used = 0;
+    int weights = 0;
+    for (int i = 0; i < n; i++)
+    {
+        const MEBConstraint &c = children[i]->constraint;
+        int s = 0;
+        if (c.fixed >= 0)
+            s = c.fixed;
+        else if (c.percent >= 0)
+            s = (long)length * c.percent / 100;
+        else
+            weights += c.flex;
+
+        sizes[i] = std::max(c.min_cells, std::min(s, c.max_cells));
+        used += sizes[i];
+    }
+
+    int left = length - used;
+    while (left > 0 && weights > 0)
+    {
+        int given = 0;
+        int next_weights = 0;
+        for (int i = 0; i < n; i++)
+        {
+            const MEBConstraint &c = children[i]->constraint;
+            if (c.fixed >= 0 || c.percent >= 0 || c.flex <= 0 || sizes[i] >= c.max_cells)
+                continue;
+
+            int s = std::min(sizes[i] + (int)((long)left * c.flex / weights), c.max_cells);
+            given += s - sizes[i];
+            sizes[i] = s;
+            if (s < c.max_cells)
+                next_weights += c.flex;
+        }
+
+        if (given == 0)
+        {
+            // Less than a cell per unit of weight is left; hand it out a cell at a time.
+            for (int i = 0; i < n && given < left; i++)
+            {
+                const MEBConstraint &c = children[i]->constraint;
+                if (c.fixed < 0 && c.percent < 0 && c.flex > 0 && sizes[i] < c.max_cells)
+                {
+                    sizes[i]++;
+                    given++;
+                }
+            }
+            if (given == 0)
+                break;
+        }
+
+        left -= given;
+        weights = next_weights;
+    }
+
+    for (int i = n - 1; i >= 0 && left < 0; i--)
+    {
+        int take = std::min(sizes[i], -left);
+        sizes[i] -= take;
+        left += take;
+    }
+}
@@ -0,0 +1,360 @@
+/**
+ * @file meb_log.cpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief A scrolling log pane fed from any thread through a lock-free ring buffer.
+ * @version See Git tags for version information.
+ * @date 2026.10.16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <ncurses.h>
+#include <menu.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <stdexcept>
+
+#include "mebgui.hpp"
+#include "meb_eventloop.hpp"
+#include "meb_log.hpp"
+
+// Spawns a log pane.
+MEBLogWindow::MEBLogWindow(MEBWindow *w, int x, int y, int cols, int rows, int scrollback /* = MEB_LOG_DEFAULT_SCROLLBACK */)
+{
+    if (scrollback < 1)
+        throw std::invalid_argument("Scrollback must hold at least one line.");
+
+    this->x = x;
+    this->y = y;
+    this->cols = cols < MEB_LOG_LINE_MAX ? cols : MEB_LOG_LINE_MAX - 1;
+    this->rows = rows;
+    this->parent = w;
+    this->posted_win = nullptr;
+    this->sub = nullptr;
+
+    this->capacity = scrollback;
+    this->slots = new slot[scrollback];
+    for (int i = 0; i < scrollback; i++)
+    {
+        slots[i].seq.store(0, std::memory_order_relaxed);
+        slots[i].len = 0;
+    }
+    this->head = 0;
+    this->dropped = 0;
+    this->pending = false;
+    this->loop = nullptr;
+
+    this->follow = true;
+    this->view_bottom = 0;
+    this->drawn_top = this->drawn_bottom = 0;
+    this->redraw = true;
+
+    Refresh();
+
+    MEBScreen::Get()->Register(this);
+}
+
+// Destructor.
+MEBLogWindow::~MEBLogWindow()
+{
+    MEBScreen::Get()->Unregister(this);
+
+    if (sub != nullptr)
+    {
+        werase(sub);
+        delwin(sub);
+    }
+    delete[] slots;
+}
+
+// Wakes the loop when lines arrive.
+void MEBLogWindow::Attach(MEBEventLoop *loop)
+{
+    this->loop = loop;
+}
+
+// Appends text, one line per newline-separated part.
+void MEBLogWindow::Append(const char *text)
+{
+    const char *p = text;
+    do
+    {
+        const char *nl = strchr(p, '\n');
+        size_t len = nl != NULL ? (size_t)(nl - p) : strlen(p);
+        append_line(p, len);
+        p = nl != NULL ? nl + 1 : NULL;
+    } while (p != NULL && *p != '\0'); // A trailing newline does not start an empty line.
+
+    // Only the append which finds the pane idle needs to wake the UI thread.
+    if (!pending.exchange(true, std::memory_order_acq_rel) && loop != nullptr)
+        loop->Wakeup();
+}
+
+// Formats text and appends it.
+void MEBLogWindow::Printf(const char *fmt, ...)
+{
+    char buf[4 * MEB_LOG_LINE_MAX];
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+
+    Append(buf);
+}
+
+// Draws whatever changed since the last frame.
+void MEBLogWindow::Render()
+{
+    if (parent->win != nullptr && posted_win != parent->win)
+        Refresh();
+    if (sub == nullptr)
+        return;
+
+    // Cleared before reading, so lines appended from here on wake the UI thread again.
+    pending.store(false, std::memory_order_release);
+
+    uint64_t end = head.load(std::memory_order_acquire);
+    uint64_t oldest = end > (uint64_t)capacity ? end - capacity : 0;
+
+    uint64_t bottom = end;
+    if (!follow)
+    {
+        // Lines scrolled back to may since have been overwritten; hold the view at the oldest still kept.
+        if (view_bottom < oldest + rows)
+            view_bottom = std::min(end, oldest + rows);
+        bottom = view_bottom;
+    }
+
+    uint64_t top = bottom > (uint64_t)rows ? bottom - rows : 0;
+    if (top < oldest)
+        top = oldest;
+
+    if (!redraw && top == drawn_top && bottom == drawn_bottom)
+        return;
+
+    int64_t shift = (int64_t)(top - drawn_top);
+    if (redraw || drawn_top == drawn_bottom || shift >= rows || shift <= -rows)
+    {
+        werase(sub);
+        drawn_top = drawn_bottom = top;
+    }
+    else if (shift != 0)
+    {
+        // Rows still showing lines which remain in view are moved rather than drawn again.
+        scrollok(sub, TRUE);
+        wscrl(sub, (int)shift);
+        scrollok(sub, FALSE);
+    }
+    redraw = false;
+
+    // Draw the rows whose line changed; rows whose line left the view and was not scrolled off are blanked.
+    for (int r = 0; r < rows; r++)
+    {
+        uint64_t l = top + r;
+        bool shown = l < bottom;
+        bool was_shown = l >= drawn_top && l < drawn_bottom;
+
+        if (shown && !was_shown)
+            draw_row(r, l);
+        else if (!shown && was_shown)
+        {
+            wmove(sub, r, 0);
+            wclrtoeol(sub);
+        }
+    }
+
+    // The sub-window shares the parent's cells, but the parent must be told which of its lines changed.
+    wsyncup(sub);
+
+    drawn_top = top;
+    drawn_bottom = bottom;
+}
+
+// Handles scrolling keys.
+bool MEBLogWindow::Update(int in)
+{
+    switch (in)
+    {
+    case KEY_UP:
+        Scroll(-1);
+        return true;
+    case KEY_DOWN:
+        Scroll(1);
+        return true;
+    case KEY_PPAGE:
+        Scroll(-rows);
+        return true;
+    case KEY_NPAGE:
+        Scroll(rows);
+        return true;
+    case KEY_HOME:
+        Scroll(-capacity);
+        return true;
+    case KEY_END:
+        Follow();
+        return true;
+    }
+
+    return false;
+}
+
+// Scrolls the view.
+void MEBLogWindow::Scroll(int delta)
+{
+    uint64_t end = head.load(std::memory_order_acquire);
+    uint64_t oldest = end > (uint64_t)capacity ? end - capacity : 0;
+
+    int64_t bottom = follow ? (int64_t)drawn_bottom : (int64_t)view_bottom;
+    bottom += delta;
+
+    int64_t lowest = (int64_t)std::min(end, oldest + rows);
+    if (bottom < lowest)
+        bottom = lowest;
+
+    if (bottom >= (int64_t)end)
+    {
+        Follow();
+        return;
+    }
+
+    follow = false;
+    view_bottom = bottom;
+    MEBScreen::Get()->Present();
+}
+
+// Jumps to, and follows, the tail.
+void MEBLogWindow::Follow()
+{
+    follow = true;
+    MEBScreen::Get()->Present();
+}
+
+// Moves the pane some delta-position.
+void MEBLogWindow::Move(int dx, int dy)
+{
+    counters.moves++;
+    x += dx;
+    y += dy;
+
+    Refresh();
+}
+
+// Recreates the pane's sub-window and redraws it.
+void MEBLogWindow::Refresh()
+{
+    if (sub != nullptr)
+    {
+        werase(sub);
+        delwin(sub);
+        sub = nullptr;
+    }
+
+    posted_win = parent->win;
+    if (parent->win != nullptr)
+        sub = derwin(parent->win, rows, cols, y, x);
+
+    redraw = true;
+    MEBScreen::Get()->Present();
+}
+
+// Deletes the sub-window if it was made from w.
+void MEBLogWindow::Release(WINDOW *w)
+{
+    if (sub == nullptr || posted_win != w)
+        return;
+
+    delwin(sub);
+    sub = nullptr;
+    posted_win = nullptr;
+}
+
+// FOR INTERNAL USE ONLY
+// Claims the next slot and publishes one line into it.
+void MEBLogWindow::append_line(const char *text, size_t len)
+{
+    uint64_t l = head.fetch_add(1, std::memory_order_relaxed);
+    slot &s = slots[l % capacity];
+
+    // The slot should hold a line one lap older. If a writer from a lap ago is still busy with it, or one from a later
+    // lap already took it, this line is lost rather than waited for.
+    uint64_t seq = s.seq.load(std::memory_order_relaxed);
+    if ((seq & 1) || seq > 2 * l || !s.seq.compare_exchange_strong(seq, 2 * l + 1, std::memory_order_relaxed))
+    {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+
+    // Tabs are expanded and control characters replaced, so a line never moves the cursor off its row.
+    int n = 0;
+    for (size_t i = 0; i < len && n < MEB_LOG_LINE_MAX - 1; i++)
+    {
+        unsigned char c = text[i];
+        if (c == '\t')
+        {
+            do
+                s.text[n++] = ' ';
+            while (n % 8 != 0 && n < MEB_LOG_LINE_MAX - 1);
+        }
+        else if (c == '\r')
+            continue;
+        else
+            s.text[n++] = (c < ' ' || c == 127) ? '?' : c;
+    }
+    s.len = n;
+
+    s.seq.store(2 * l + 2, std::memory_order_release);
+}
+
+// FOR INTERNAL USE ONLY
+// Copies a line out of its slot. Returns false if the line is being written, or has been overwritten.
+bool MEBLogWindow::read_line(uint64_t l, char *out, int *len)
+{
+    slot &s = slots[l % capacity];
+
+    uint64_t seq = s.seq.load(std::memory_order_acquire);
+    if (seq != 2 * l + 2)
+        return false;
+
+    int n = s.len;
+    if (n > cols)
+        n = cols;
+    memcpy(out, s.text, n);
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    *len = n;
+    return s.seq.load(std::memory_order_relaxed) == seq;
+}
+
+// FOR INTERNAL USE ONLY
+// Draws one line on one row of the pane.
+void MEBLogWindow::draw_row(int r, uint64_t l)
+{
+    int len = 0;
+    if (!read_line(l, line, &len))
+    {
+        // Still being written, or lost to a lapping writer; drawn again next frame.
+        len = 0;
+        redraw = true;
+    }
+
+    mvwaddnstr(sub, r, 0, line, len);
+    if (len < cols)
+        wclrtoeol(sub);
+}
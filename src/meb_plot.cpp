@@ -0,0 +1,426 @@
+/**
+ * @file meb_plot.cpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief A scrolling time-series plot, decimating samples into per-column minimum / maximum buckets as they arrive.
+ * @version See Git tags for version information.
+ * @date 2026.10.16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <ncurses.h>
+#include <menu.h>
+#include <string.h>
+#include <algorithm>
+#include <stdexcept>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "mebgui.hpp"
+#include "meb_eventloop.hpp"
+#include "meb_plot.hpp"
+
+namespace
+{
+    // Finds the smallest and largest of n >= 1 samples.
+    void min_max(const float *p, size_t n, float *lo, float *hi)
+    {
+        size_t i = 1;
+        float l = p[0];
+        float h = p[0];
+
+#ifdef __SSE2__
+        if (n >= 8)
+        {
+            // Four lanes at a time, folded together at the end.
+            __m128 vl = _mm_loadu_ps(p);
+            __m128 vh = vl;
+            for (i = 4; i + 4 <= n; i += 4)
+            {
+                __m128 v = _mm_loadu_ps(p + i);
+                vl = _mm_min_ps(vl, v);
+                vh = _mm_max_ps(vh, v);
+            }
+
+            float ls[4], hs[4];
+            _mm_storeu_ps(ls, vl);
+            _mm_storeu_ps(hs, vh);
+            l = std::min(std::min(ls[0], ls[1]), std::min(ls[2], ls[3]));
+            h = std::max(std::max(hs[0], hs[1]), std::max(hs[2], hs[3]));
+        }
+#endif
+
+        for (; i < n; i++)
+        {
+            l = std::min(l, p[i]);
+            h = std::max(h, p[i]);
+        }
+
+        *lo = l;
+        *hi = h;
+    }
+}
+
+// Spawns an empty plot.
+MEBPlot::MEBPlot(MEBWindow *w, int x, int y, int cols, int rows, int samples_per_col /* = 1 */, int capacity /* = MEB_PLOT_DEFAULT_CAPACITY */)
+{
+    if (cols < 1 || rows < 1)
+        throw std::invalid_argument("Plot must be at least one cell in size.");
+    if (capacity < 1)
+        throw std::invalid_argument("Plot must keep at least one sample.");
+
+    this->x = x;
+    this->y = y;
+    this->cols = cols;
+    this->rows = rows;
+    this->parent = w;
+    this->posted_win = nullptr;
+    this->sub = nullptr;
+    this->loop = nullptr;
+
+    this->ring.assign(capacity, 0);
+    this->buckets.resize(cols);
+    this->bucket_at = 0;
+    this->n_buckets = 0;
+    this->open = bucket();
+    this->spc = std::max(samples_per_col, 1);
+    this->total = 0;
+    this->pending = false;
+
+    this->auto_range = true;
+    this->range_lo = 0;
+    this->range_hi = 1;
+    this->redraw = true;
+    this->shown.reserve(cols + 1);
+
+    Refresh();
+
+    MEBScreen::Get()->Register(this);
+}
+
+// Destructor.
+MEBPlot::~MEBPlot()
+{
+    MEBScreen::Get()->Unregister(this);
+
+    if (sub != nullptr)
+    {
+        werase(sub);
+        wsyncup(sub);
+        delwin(sub);
+    }
+    MEBScreen::Get()->Present();
+}
+
+// Wakes the loop when samples arrive.
+void MEBPlot::Attach(MEBEventLoop *loop)
+{
+    this->loop = loop;
+}
+
+// Appends samples.
+void MEBPlot::Push(const float *samples, size_t n)
+{
+    if (n == 0)
+        return;
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        fold(samples, n);
+    }
+
+    // Only the push which finds the plot drawn needs to wake the UI thread.
+    if (!pending.exchange(true, std::memory_order_acq_rel) && loop != nullptr)
+        loop->Wakeup();
+}
+
+// Changes how many samples each column covers.
+void MEBPlot::SetSamplesPerColumn(int n)
+{
+    n = std::max(n, 1);
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        if (n == spc)
+            return;
+        spc = n;
+        rebucket();
+    }
+
+    redraw = true;
+    MEBScreen::Get()->Present();
+}
+
+// Fixes the vertical range.
+void MEBPlot::SetRange(float lo, float hi)
+{
+    auto_range = false;
+    range_lo = lo;
+    range_hi = hi;
+    redraw = true;
+    MEBScreen::Get()->Present();
+}
+
+// Fits the vertical range to the samples shown.
+void MEBPlot::SetAutoRange()
+{
+    auto_range = true;
+    redraw = true;
+    MEBScreen::Get()->Present();
+}
+
+// Returns the most recent sample.
+float MEBPlot::Last()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    uint64_t t = total.load(std::memory_order_relaxed);
+    return t > 0 ? ring[(t - 1) % ring.size()] : 0;
+}
+
+// Draws the buckets if anything changed since the last frame.
+void MEBPlot::Render()
+{
+    if (parent->win != nullptr && posted_win != parent->win)
+        Refresh();
+    if (sub == nullptr)
+        return;
+
+    bool arrived = pending.exchange(false, std::memory_order_acq_rel);
+    if (!arrived && !redraw)
+        return;
+    redraw = false;
+
+    // Copied out, so pushing threads are held up for no longer than it takes to copy one bucket per column.
+    shown.clear();
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        for (size_t k = 0; k < n_buckets; k++)
+            shown.push_back(buckets[(bucket_at + cols - n_buckets + k) % cols]);
+        if (open.count > 0)
+            shown.push_back(open);
+    }
+    if ((int)shown.size() > cols)
+        shown.erase(shown.begin());
+
+    werase(sub);
+
+    if (!shown.empty())
+    {
+        float lo = range_lo;
+        float hi = range_hi;
+        if (auto_range)
+        {
+            lo = shown[0].lo;
+            hi = shown[0].hi;
+            for (size_t i = 1; i < shown.size(); i++)
+            {
+                lo = std::min(lo, shown[i].lo);
+                hi = std::max(hi, shown[i].hi);
+            }
+        }
+
+        // A flat series is drawn across the middle.
+        if (!(hi > lo))
+        {
+            lo -= 0.5f;
+            hi += 0.5f;
+        }
+
+        // The newest bucket is at the right edge.
+        int x0 = cols - shown.size();
+        for (size_t i = 0; i < shown.size(); i++)
+            draw_column(x0 + i, shown[i], lo, hi);
+    }
+
+    // The sub-window shares the parent's cells, but the parent must be told which of its lines changed.
+    wsyncup(sub);
+}
+
+// Moves the plot some delta-position.
+void MEBPlot::Move(int dx, int dy)
+{
+    counters.moves++;
+    x += dx;
+    y += dy;
+
+    Refresh();
+}
+
+// Recreates the plot's sub-window and redraws it.
+void MEBPlot::Refresh()
+{
+    if (sub != nullptr)
+    {
+        werase(sub);
+        delwin(sub);
+        sub = nullptr;
+    }
+
+    posted_win = parent->win;
+    if (parent->win != nullptr)
+        sub = derwin(parent->win, rows, cols, y, x);
+
+    redraw = true;
+    MEBScreen::Get()->Present();
+}
+
+// Deletes the sub-window if it was made from w.
+void MEBPlot::Release(WINDOW *w)
+{
+    if (sub == nullptr || posted_win != w)
+        return;
+
+    delwin(sub);
+    sub = nullptr;
+    posted_win = nullptr;
+}
+
+// FOR INTERNAL USE ONLY
+// Keeps the samples and folds them into the buckets. Called with the lock held.
+void MEBPlot::fold(const float *samples, size_t n)
+{
+    size_t cap = ring.size();
+    uint64_t t = total.load(std::memory_order_relaxed);
+    total.store(t + n, std::memory_order_relaxed);
+
+    // Only the newest samples of a batch larger than the ring are kept.
+    const float *keep = samples;
+    size_t n_keep = n;
+    if (n_keep > cap)
+    {
+        keep += n_keep - cap;
+        n_keep = cap;
+    }
+    size_t at = (t + (n - n_keep)) % cap;
+    size_t first = std::min(n_keep, cap - at);
+    memcpy(&ring[at], keep, first * sizeof(float));
+    memcpy(&ring[0], keep + first, (n_keep - first) * sizeof(float));
+
+    while (n > 0)
+    {
+        if (open.count == 0)
+        {
+            // Whole buckets which would be pushed out of the ring by later ones in this batch are never made.
+            size_t whole = n / spc;
+            if (whole > (size_t)cols)
+            {
+                size_t skip = (whole - cols) * spc;
+                samples += skip;
+                n -= skip;
+            }
+        }
+
+        size_t k = std::min(n, (size_t)(spc - open.count));
+        float lo, hi;
+        min_max(samples, k, &lo, &hi);
+
+        if (open.count == 0)
+        {
+            open.lo = lo;
+            open.hi = hi;
+        }
+        else
+        {
+            open.lo = std::min(open.lo, lo);
+            open.hi = std::max(open.hi, hi);
+        }
+        open.last = samples[k - 1];
+        open.count += k;
+
+        if (open.count == (uint32_t)spc)
+        {
+            buckets[bucket_at] = open;
+            bucket_at = (bucket_at + 1) % cols;
+            n_buckets = std::min(n_buckets + 1, (size_t)cols);
+            open.count = 0;
+        }
+
+        samples += k;
+        n -= k;
+    }
+}
+
+// FOR INTERNAL USE ONLY
+// Reduces kept samples [from, to), by their number since the first push, into a bucket. Called with the lock held.
+void MEBPlot::reduce(uint64_t from, uint64_t to, bucket &b)
+{
+    size_t cap = ring.size();
+    b.count = 0;
+
+    while (from < to)
+    {
+        size_t at = from % cap;
+        size_t k = std::min((uint64_t)(cap - at), to - from);
+
+        float lo, hi;
+        min_max(&ring[at], k, &lo, &hi);
+        b.lo = b.count == 0 ? lo : std::min(b.lo, lo);
+        b.hi = b.count == 0 ? hi : std::max(b.hi, hi);
+        b.last = ring[at + k - 1];
+        b.count += k;
+        from += k;
+    }
+}
+
+// FOR INTERNAL USE ONLY
+// Rebuilds the buckets from the samples kept, after the samples per column changed. Called with the lock held.
+void MEBPlot::rebucket()
+{
+    uint64_t t = total.load(std::memory_order_relaxed);
+    uint64_t oldest = t - std::min(t, (uint64_t)ring.size());
+    uint64_t open_start = t - t % spc;
+
+    reduce(std::max(open_start, oldest), t, open);
+
+    // Buckets whose first samples are no longer kept are left out.
+    size_t n = 0;
+    while ((int)n < cols && open_start >= oldest + (n + 1) * spc)
+        n++;
+
+    for (size_t k = 0; k < n; k++)
+    {
+        uint64_t start = open_start - (n - k) * spc;
+        reduce(start, start + spc, buckets[k]);
+    }
+    n_buckets = n;
+    bucket_at = n % cols;
+}
+
+// FOR INTERNAL USE ONLY
+// Draws one bucket as a bar from its minimum to its maximum, or a scan line if both fall on the same level.
+void MEBPlot::draw_column(int c, const bucket &b, float lo, float hi)
+{
+    int levels = rows * MEB_PLOT_LEVELS_PER_ROW;
+    float scale = levels / (hi - lo);
+
+    int top = std::max(std::min((int)((b.hi - lo) * scale), levels - 1), 0);
+    int bottom = std::max(std::min((int)((b.lo - lo) * scale), levels - 1), 0);
+    int r_top = rows - 1 - top / MEB_PLOT_LEVELS_PER_ROW;
+    int r_bottom = rows - 1 - bottom / MEB_PLOT_LEVELS_PER_ROW;
+
+    if (top == bottom)
+    {
+        // Lowest first.
+        const chtype scan[MEB_PLOT_LEVELS_PER_ROW] = {ACS_S9, ACS_S7, ACS_S3, ACS_S1};
+        mvwaddch(sub, r_top, c, scan[top % MEB_PLOT_LEVELS_PER_ROW]);
+        return;
+    }
+
+    for (int r = r_top; r <= r_bottom; r++)
+        mvwaddch(sub, r, c, ACS_VLINE);
+}
@@ -0,0 +1,431 @@
+/**
+ * @file meb_print.cpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief The asynchronous backend for the meb_print.h macros, used when MEB_PRINT_ASYNC is defined.
+ * @version See Git tags for version information.
+ * @date 2026.10.16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <errno.h>
+#include <sched.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef MEB_PRINT_ASYNC
+#define MEB_PRINT_ASYNC
+#endif
+#include "meb_print.h"
+
+// Bytes buffered per printing thread; a power of two.
+#define MEB_PRINT_THREAD_BUFFER 65536
+
+namespace
+{
+    // A single-producer, single-consumer byte ring. Each message is a header followed by its text.
+    struct thread_buffer
+    {
+        char data[MEB_PRINT_THREAD_BUFFER];
+        std::atomic<uint64_t> head; // Written by the owning thread.
+        std::atomic<uint64_t> tail; // Written by the writer.
+        std::atomic<bool> orphaned; // The owning thread has exited; freed by the writer once drained.
+    };
+
+    struct message_header
+    {
+        uint32_t len;
+        uint32_t stream;
+    };
+
+    class backend
+    {
+    public:
+        backend();
+        ~backend();
+
+        thread_buffer *attach();
+        void wake();
+        void flush();
+        void set_sink(void (*sink)(void *, int, const char *), void *ctx);
+
+    private:
+        void writer();
+        bool drain(thread_buffer *b);
+        bool pending();
+        void emit(void (*sink)(void *, int, const char *), void *ctx);
+
+        std::mutex lock;
+        std::condition_variable cv;
+        std::thread thread;
+        bool quit;
+        std::atomic<bool> sleeping;
+        bool woken;
+        uint64_t flush_requested;
+        uint64_t flush_done;
+
+        std::vector<thread_buffer *> buffers;
+
+        // Writer thread only.
+        std::string out[2];  // Batched text for each stream.
+        std::string line[2]; // Sink mode: the unfinished line of each stream.
+
+        void (*sink)(void *, int, const char *);
+        void *sink_ctx;
+    };
+
+    backend the_backend;
+
+    // Registers the thread's buffer on first use, and orphans it when the thread exits.
+    struct thread_handle
+    {
+        thread_buffer *buffer;
+
+        thread_handle() : buffer(nullptr) {}
+        ~thread_handle()
+        {
+            if (buffer != nullptr)
+            {
+                buffer->orphaned.store(true, std::memory_order_release);
+                the_backend.wake();
+            }
+        }
+    };
+
+    thread_local thread_handle this_thread;
+
+    void ring_write(thread_buffer *b, uint64_t pos, const void *src, size_t len)
+    {
+        size_t off = pos & (MEB_PRINT_THREAD_BUFFER - 1);
+        size_t first = len < MEB_PRINT_THREAD_BUFFER - off ? len : MEB_PRINT_THREAD_BUFFER - off;
+        memcpy(b->data + off, src, first);
+        memcpy(b->data, (const char *)src + first, len - first);
+    }
+
+    void ring_read(thread_buffer *b, uint64_t pos, void *dst, size_t len)
+    {
+        size_t off = pos & (MEB_PRINT_THREAD_BUFFER - 1);
+        size_t first = len < MEB_PRINT_THREAD_BUFFER - off ? len : MEB_PRINT_THREAD_BUFFER - off;
+        memcpy(dst, b->data + off, first);
+        memcpy((char *)dst + first, b->data, len - first);
+    }
+
+    void write_all(int fd, const std::string &s)
+    {
+        size_t done = 0;
+        while (done < s.size())
+        {
+            ssize_t n = write(fd, s.data() + done, s.size() - done);
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n <= 0)
+                return;
+            done += n;
+        }
+    }
+}
+
+backend::backend()
+{
+    quit = false;
+    sleeping = false;
+    woken = false;
+    flush_requested = 0;
+    flush_done = 0;
+    sink = nullptr;
+    sink_ctx = nullptr;
+}
+
+// Writes out everything still buffered.
+backend::~backend()
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        quit = true;
+    }
+    cv.notify_all();
+
+    if (thread.joinable())
+        thread.join();
+}
+
+// Creates and registers a buffer for the calling thread, starting the writer on first use.
+thread_buffer *backend::attach()
+{
+    thread_buffer *b = new thread_buffer;
+    b->head = 0;
+    b->tail = 0;
+    b->orphaned = false;
+
+    std::lock_guard<std::mutex> guard(lock);
+    buffers.push_back(b);
+    if (!thread.joinable())
+        thread = std::thread(&backend::writer, this);
+    return b;
+}
+
+// Wakes the writer if it is idle.
+void backend::wake()
+{
+    // Pairs with the fence in writer(): either the writer sees what was just published, or this sees it sleeping.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!sleeping.load(std::memory_order_relaxed))
+        return;
+
+    std::lock_guard<std::mutex> guard(lock);
+    woken = true;
+    cv.notify_all(); // Flushing threads wait on the same condition.
+}
+
+// Blocks until the writer has completed a pass begun after this call.
+void backend::flush()
+{
+    std::unique_lock<std::mutex> guard(lock);
+    if (!thread.joinable())
+        return;
+
+    uint64_t target = ++flush_requested;
+    cv.notify_all();
+    cv.wait(guard, [this, target]()
+            { return flush_done >= target; });
+}
+
+// Sets the sink; on return, the old one is neither running nor about to be.
+void backend::set_sink(void (*sink)(void *, int, const char *), void *ctx)
+{
+    // What was printed so far goes to the old sink.
+    flush();
+
+    std::unique_lock<std::mutex> guard(lock);
+    this->sink = sink;
+    this->sink_ctx = ctx;
+    if (!thread.joinable())
+        return;
+
+    // The writer may have copied the old sink before the swap; a pass begun after it has let go of that copy.
+    uint64_t target = ++flush_requested;
+    cv.notify_all();
+    cv.wait(guard, [this, target]()
+            { return flush_done >= target; });
+}
+
+// Drains every thread's buffer in turn and writes the lot with one write(...) per stream.
+void backend::writer()
+{
+    std::unique_lock<std::mutex> guard(lock);
+
+    while (true)
+    {
+        uint64_t requested = flush_requested;
+        bool any = false;
+
+        for (size_t i = 0; i < buffers.size();)
+        {
+            thread_buffer *b = buffers[i];
+            bool orphaned = b->orphaned.load(std::memory_order_acquire);
+            any |= drain(b);
+
+            if (orphaned)
+            {
+                delete b;
+                buffers.erase(buffers.begin() + i);
+            }
+            else
+                i++;
+        }
+
+        if (any || (quit && (!line[0].empty() || !line[1].empty())))
+        {
+            void (*s)(void *, int, const char *) = sink;
+            void *ctx = sink_ctx;
+            guard.unlock();
+            emit(s, ctx);
+            guard.lock();
+        }
+
+        if (flush_done < requested)
+        {
+            flush_done = requested;
+            cv.notify_all();
+        }
+
+        if (any)
+            continue;
+        if (quit)
+            return;
+
+        // Pairs with the fence in wake(), so a message published as the writer goes to sleep is never missed.
+        sleeping.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        cv.wait(guard, [this]()
+                { return quit || woken || flush_done < flush_requested || pending(); });
+        sleeping.store(false, std::memory_order_relaxed);
+        woken = false;
+    }
+}
+
+// FOR INTERNAL USE ONLY
+// Returns true if any buffer holds messages, or belongs to a thread which has exited.
+bool backend::pending()
+{
+    for (size_t i = 0; i < buffers.size(); i++)
+    {
+        thread_buffer *b = buffers[i];
+        if (b->head.load(std::memory_order_acquire) != b->tail.load(std::memory_order_relaxed) ||
+            b->orphaned.load(std::memory_order_acquire))
+            return true;
+    }
+    return false;
+}
+
+// Moves one buffer's messages into the batches. Returns true if there were any.
+bool backend::drain(thread_buffer *b)
+{
+    uint64_t head = b->head.load(std::memory_order_acquire);
+    uint64_t tail = b->tail.load(std::memory_order_relaxed);
+    if (head == tail)
+        return false;
+
+    while (tail != head)
+    {
+        message_header h;
+        ring_read(b, tail, &h, sizeof(h));
+        tail += sizeof(h);
+
+        std::string &o = out[h.stream];
+        size_t at = o.size();
+        o.resize(at + h.len);
+        ring_read(b, tail, &o[at], h.len);
+        tail += h.len;
+    }
+
+    b->tail.store(tail, std::memory_order_release);
+    return true;
+}
+
+// Writes the batches to their streams or hands them, line by line, to the sink.
+void backend::emit(void (*sink)(void *, int, const char *), void *ctx)
+{
+    for (int s = 0; s < 2; s++)
+    {
+        if (sink == nullptr)
+        {
+            write_all(s == MEB_PRINT_STDOUT ? STDOUT_FILENO : STDERR_FILENO, out[s]);
+            out[s].clear();
+            continue;
+        }
+
+        for (size_t i = 0; i < out[s].size(); i++)
+        {
+            char c = out[s][i];
+            if (c == '\x1b' && i + 1 < out[s].size() && out[s][i + 1] == '[')
+            {
+                // Colors mean nothing to a sink; skip the escape sequence.
+                i += 2;
+                while (i < out[s].size() && !(out[s][i] >= '@' && out[s][i] <= '~'))
+                    i++;
+            }
+            else if (c == '\n')
+            {
+                sink(ctx, s, line[s].c_str());
+                line[s].clear();
+            }
+            else
+                line[s].push_back(c);
+        }
+        out[s].clear();
+
+        // At exit, a last unfinished line is still worth showing.
+        if (quit && !line[s].empty())
+        {
+            sink(ctx, s, line[s].c_str());
+            line[s].clear();
+        }
+    }
+}
+
+// Formats a message into the calling thread's buffer for the background writer.
+int meb_print_async(int stream, const char *format, ...)
+{
+    char stack[512];
+    std::string heap;
+    char *text = stack;
+
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(stack, sizeof(stack), format, args);
+    va_end(args);
+
+    if (len < 0)
+        return len;
+    if (len >= (int)sizeof(stack))
+    {
+        heap.resize(len + 1);
+        va_start(args, format);
+        vsnprintf(&heap[0], len + 1, format, args);
+        va_end(args);
+        text = &heap[0];
+    }
+
+    thread_buffer *b = this_thread.buffer;
+    if (b == nullptr)
+        b = this_thread.buffer = the_backend.attach();
+
+    // A message never takes more than half the ring, so one always fits once the writer catches up.
+    message_header h;
+    h.len = len < MEB_PRINT_THREAD_BUFFER / 2 ? len : MEB_PRINT_THREAD_BUFFER / 2;
+    h.stream = stream == MEB_PRINT_STDERR ? MEB_PRINT_STDERR : MEB_PRINT_STDOUT;
+    size_t need = sizeof(h) + h.len;
+
+    uint64_t head = b->head.load(std::memory_order_relaxed);
+    while (head + need - b->tail.load(std::memory_order_acquire) > MEB_PRINT_THREAD_BUFFER)
+    {
+        // Full; the only time a printing thread waits.
+        the_backend.wake();
+        sched_yield();
+    }
+
+    ring_write(b, head, &h, sizeof(h));
+    ring_write(b, head + sizeof(h), text, h.len);
+    b->head.store(head + need, std::memory_order_release);
+
+    // Always wake: the writer may have drained the ring and gone to sleep since tail was read.
+    the_backend.wake();
+
+    return len;
+}
+
+// Blocks until everything printed so far has been written.
+void meb_print_flush(void)
+{
+    the_backend.flush();
+}
+
+// Sends output to a callback instead of stdout / stderr.
+void meb_print_set_sink(void (*sink)(void *ctx, int stream, const char *line), void *ctx)
+{
+    the_backend.set_sink(sink, ctx);
+}
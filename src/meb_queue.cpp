@@ -0,0 +1,209 @@
+/**
+ * @file meb_queue.cpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief A lock-free queue through which any thread can post UI work to the NCURSES thread.
+ * @version See Git tags for version information.
+ * @date 2026.10.16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <ncurses.h>
+#include <menu.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "mebgui.hpp"
+#include "meb_eventloop.hpp"
+#include "meb_queue.hpp"
+
+// Creates an empty queue.
+MEBCommandQueue::MEBCommandQueue()
+{
+    stub.next = nullptr;
+    stub.target = nullptr;
+    stub.kind = MEB_CMD_NONE;
+    head = &stub;
+    tail = &stub;
+    pending = false;
+    loop = nullptr;
+}
+
+// Discards any commands still queued.
+MEBCommandQueue::~MEBCommandQueue()
+{
+    node *n;
+    while ((n = pop()) != nullptr)
+        delete n;
+}
+
+// Drains the queue on the loop's thread whenever commands are posted.
+void MEBCommandQueue::Attach(MEBEventLoop *loop)
+{
+    this->loop = loop;
+    loop->OnWakeup([this]()
+                   { Drain(); });
+
+    if (!Empty())
+        loop->Wakeup();
+}
+
+// Posts a command.
+void MEBCommandQueue::Post(std::function<void()> fn, const void *target /* = nullptr */, uint64_t kind /* = MEB_CMD_NONE */)
+{
+    node *n = new node;
+    n->next.store(nullptr, std::memory_order_relaxed);
+    n->fn = fn;
+    n->target = target;
+    n->kind = kind;
+
+    // Vyukov's intrusive MPSC push: one exchange, then link the previous head to us.
+    node *prev = head.exchange(n, std::memory_order_acq_rel);
+    prev->next.store(n, std::memory_order_release);
+
+    // Only the post which finds the queue idle needs to wake the consumer.
+    if (!pending.exchange(true, std::memory_order_acq_rel) && loop != nullptr)
+        loop->Wakeup();
+}
+
+// Posts MEBWindow::MoveTo(...).
+void MEBCommandQueue::PostMoveTo(MEBWindow *w, int x, int y)
+{
+    Post([w, x, y]()
+         { w->MoveTo(x, y); },
+         w, MEB_CMD_MOVE);
+}
+
+// Posts MEBWindow::ResizeTo(...).
+void MEBCommandQueue::PostResizeTo(MEBWindow *w, int cols, int rows)
+{
+    Post([w, cols, rows]()
+         { w->ResizeTo(cols, rows); },
+         w, MEB_CMD_RESIZE);
+}
+
+// Formats text on the calling thread and posts printing it into a MEBWindow.
+void MEBCommandQueue::PostPrint(MEBWindow *w, int x, int y, const char *fmt, ...)
+{
+    char buf[256];
+    va_list args;
+    va_start(args, fmt);
+    int len = vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+
+    std::string text(buf);
+    if (len >= (int)sizeof(buf))
+    {
+        text.resize(len + 1);
+        va_start(args, fmt);
+        vsnprintf(&text[0], len + 1, fmt, args);
+        va_end(args);
+        text.resize(len);
+    }
+
+    Post([w, x, y, text]()
+         {
+        mvwaddstr(w->win, y, x, text.c_str());
+        MEBScreen::Get()->Present(); },
+         w, MEB_CMD_PRINT(x, y));
+}
+
+// Runs every queued command.
+int MEBCommandQueue::Drain()
+{
+    // Cleared before popping, so anything posted from here on wakes us again.
+    pending.store(false, std::memory_order_release);
+
+    std::vector<node *> batch;
+    node *n;
+    while ((n = pop()) != nullptr)
+        batch.push_back(n);
+
+    // Index of the last command for each (target, kind); earlier ones are superseded.
+    std::map<std::pair<const void *, uint64_t>, size_t> last;
+    for (size_t i = 0; i < batch.size(); i++)
+    {
+        if (batch[i]->target != nullptr)
+            last[std::make_pair(batch[i]->target, batch[i]->kind)] = i;
+    }
+
+    int ran = 0;
+    MEBScreen::Get()->BeginFrame();
+    for (size_t i = 0; i < batch.size(); i++)
+    {
+        node *c = batch[i];
+        if (c->target == nullptr || last[std::make_pair(c->target, c->kind)] == i)
+        {
+            c->fn();
+            ran++;
+        }
+        delete c;
+    }
+    MEBScreen::Get()->EndFrame();
+
+    return ran;
+}
+
+// Returns true if no commands are queued.
+bool MEBCommandQueue::Empty()
+{
+    return tail == &stub && stub.next.load(std::memory_order_acquire) == nullptr;
+}
+
+// FOR INTERNAL USE ONLY
+// Vyukov's intrusive MPSC pop. Returns nullptr when empty, or while a producer is between its two push steps; that
+// producer's wake-up guarantees another Drain().
+MEBCommandQueue::node *MEBCommandQueue::pop()
+{
+    node *t = tail;
+    node *next = t->next.load(std::memory_order_acquire);
+
+    if (t == &stub)
+    {
+        if (next == nullptr)
+            return nullptr;
+        tail = next;
+        t = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+
+    if (next != nullptr)
+    {
+        tail = next;
+        return t;
+    }
+
+    if (t != head.load(std::memory_order_acquire))
+        return nullptr;
+
+    // t is the last node; put the stub behind it so it can be unlinked.
+    stub.next.store(nullptr, std::memory_order_relaxed);
+    node *prev = head.exchange(&stub, std::memory_order_acq_rel);
+    prev->next.store(&stub, std::memory_order_release);
+
+    next = t->next.load(std::memory_order_acquire);
+    if (next != nullptr)
+    {
+        tail = next;
+        return t;
+    }
+
+    return nullptr;
+}
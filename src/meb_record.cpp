@@ -0,0 +1,497 @@
+/**
+ * @file meb_record.cpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Records sessions, each frame's changes and every key with its time, to a compact file, and replays them.
+ * @version See Git tags for version information.
+ * @date 2026.10.16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <ncurses.h>
+#include <menu.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <stdexcept>
+
+#include "mebgui.hpp"
+#include "meb_cells.hpp"
+#include "meb_eventloop.hpp"
+#include "meb_record.hpp"
+#include "meb_stats.hpp"
+
+/*
+ * A recording is MEB_RECORD_MAGIC followed by entries, each a tag byte and the microseconds since the previous entry,
+ * then, all numbers being LEB128 varints:
+ *
+ *   'S' cols rows                   The screen size, before the first frame and whenever it changes.
+ *   'K' key                         A key read.
+ *   'F' spans {y x n run...}        A frame: the changed span of each row, n cells from (x, y).
+ *
+ * A run is (count << 1 | repeated), the attributes shared by its cells (shifted down past the character), then one
+ * character byte if repeated, or count of them if not.
+ */
+#define MEB_RECORD_SIZE 'S'
+#define MEB_RECORD_KEY 'K'
+#define MEB_RECORD_FRAME 'F'
+// Identical cells worth a repeated run rather than sitting in a literal one.
+#define MEB_RECORD_MIN_REPEAT 4
+// Longest span believed when playing back, so a damaged recording cannot ask for a huge allocation.
+#define MEB_RECORD_MAX_SPAN 65535
+
+// Creates, or replaces, a recording.
+MEBRecorder::MEBRecorder(const char *path)
+{
+    fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+        throw std::runtime_error("Failed to create recording.");
+
+    buf.reserve(MEB_RECORD_FLUSH_BYTES * 2);
+    buf.append(MEB_RECORD_MAGIC, MEB_RECORD_MAGIC_LEN);
+    last_us = MEBStats::Get()->Now();
+
+    frames = 0;
+    keys = 0;
+    bytes = 0;
+}
+
+// Writes out the rest of the recording.
+MEBRecorder::~MEBRecorder()
+{
+    flush();
+    close(fd);
+}
+
+// Records what changed on the screen since the last frame.
+void MEBRecorder::Frame()
+{
+    int rows, cols;
+    getmaxyx(newscr, rows, cols);
+    back.Resize(cols, rows);
+    back.Capture(newscr, 0, 0);
+
+    // A resized screen differs everywhere.
+    bool resized = front.Cols() != cols || front.Rows() != rows;
+    if (back.Diff(front, spans) == 0)
+        return;
+
+    if (resized)
+    {
+        entry(MEB_RECORD_SIZE);
+        put_varint(cols);
+        put_varint(rows);
+    }
+
+    entry(MEB_RECORD_FRAME);
+    put_varint(spans.size());
+    for (size_t i = 0; i < spans.size(); i++)
+    {
+        const MEBRect &s = spans[i];
+        put_varint(s.y);
+        put_varint(s.x);
+        put_varint(s.cols);
+        put_span(back.Row(s.y) + s.x, s.cols);
+    }
+
+    front.Swap(back);
+    frames++;
+
+    if (buf.size() >= MEB_RECORD_FLUSH_BYTES)
+        flush();
+}
+
+// Records a key.
+void MEBRecorder::Key(int in)
+{
+    entry(MEB_RECORD_KEY);
+    put_varint((unsigned)in);
+    keys++;
+}
+
+// FOR INTERNAL USE ONLY
+// Starts an entry, stamped with the time since the last.
+void MEBRecorder::entry(char tag)
+{
+    uint64_t now = MEBStats::Get()->Now();
+    buf += tag;
+    put_varint(now - last_us);
+    last_us = now;
+}
+
+// FOR INTERNAL USE ONLY
+void MEBRecorder::put_varint(uint64_t v)
+{
+    while (v >= 0x80)
+    {
+        buf += (char)(v | 0x80);
+        v >>= 7;
+    }
+    buf += (char)v;
+}
+
+// FOR INTERNAL USE ONLY
+// Appends cells as runs sharing one attribute.
+void MEBRecorder::put_span(const chtype *cells, int n)
+{
+    int i = 0;
+    while (i < n)
+    {
+        chtype attr = cells[i] & A_ATTRIBUTES;
+
+        int r = 1;
+        while (i + r < n && cells[i + r] == cells[i])
+            r++;
+        if (r >= MEB_RECORD_MIN_REPEAT)
+        {
+            put_varint((uint64_t)r << 1 | 1);
+            put_varint(attr >> NCURSES_ATTR_SHIFT);
+            buf += (char)(cells[i] & A_CHARTEXT);
+            i += r;
+            continue;
+        }
+
+        // A literal run ends where the attributes change, or where a repeated run would begin.
+        int j = i + r;
+        int same = 1;
+        while (j < n && (cells[j] & A_ATTRIBUTES) == attr)
+        {
+            same = cells[j] == cells[j - 1] ? same + 1 : 1;
+            if (same == MEB_RECORD_MIN_REPEAT)
+            {
+                j -= MEB_RECORD_MIN_REPEAT - 1;
+                break;
+            }
+            j++;
+        }
+
+        put_varint((uint64_t)(j - i) << 1);
+        put_varint(attr >> NCURSES_ATTR_SHIFT);
+        size_t at = buf.size();
+        buf.resize(at + (j - i));
+        char *out = &buf[at];
+        for (int k = i; k < j; k++)
+            *out++ = (char)(cells[k] & A_CHARTEXT);
+        i = j;
+    }
+}
+
+// FOR INTERNAL USE ONLY
+// Writes out what has been recorded. A recording which cannot be written is cut short rather than holding up the UI.
+void MEBRecorder::flush()
+{
+    size_t done = 0;
+    while (done < buf.size())
+    {
+        ssize_t n = write(fd, buf.data() + done, buf.size() - done);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            break;
+        done += n;
+    }
+    bytes += done;
+    buf.clear();
+}
+
+// Opens a recording.
+MEBReplay::MEBReplay(const char *path, MEBWindow *w)
+{
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        throw std::runtime_error("Failed to open recording.");
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < MEB_RECORD_MAGIC_LEN)
+    {
+        close(fd);
+        throw std::runtime_error("Recording is empty.");
+    }
+
+    void *m = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (m == MAP_FAILED)
+        throw std::runtime_error("Failed to map recording.");
+    madvise(m, st.st_size, MADV_SEQUENTIAL);
+
+    this->target = w;
+    this->map = (const uint8_t *)m;
+    this->map_len = st.st_size;
+    this->loop = nullptr;
+    this->timer = -1;
+    this->speed = 1;
+    this->rec_cols = 0;
+    this->rec_rows = 0;
+
+    if (memcmp(map, MEB_RECORD_MAGIC, MEB_RECORD_MAGIC_LEN) != 0 || !scan())
+    {
+        munmap((void *)map, map_len);
+        throw std::runtime_error("Not a recording.");
+    }
+
+    Rewind();
+}
+
+// Unmaps the recording.
+MEBReplay::~MEBReplay()
+{
+    if (loop != nullptr && timer >= 0)
+        loop->RemoveTimer(timer);
+    munmap((void *)map, map_len);
+}
+
+// Sets the callback for every key played back.
+void MEBReplay::OnKey(std::function<void(int)> cb)
+{
+    key_cb = cb;
+}
+
+// Plays the recording with the loop's timers.
+void MEBReplay::Attach(MEBEventLoop *loop)
+{
+    if (this->loop != nullptr && timer >= 0)
+        this->loop->RemoveTimer(timer);
+
+    this->loop = loop;
+    wall_us = MEBStats::Get()->Now() - (uint64_t)(rec_us / (speed > 0 ? speed : 1));
+    timer = loop->AddTimer(1, [this]()
+                           { tick(); },
+                           false);
+}
+
+// Plays the keys up to the next frame, and the frame, as one frame.
+bool MEBReplay::Step()
+{
+    if (Done())
+        return false;
+
+    MEBScreen::Get()->BeginFrame();
+    while (at < end)
+    {
+        char tag;
+        uint64_t dt;
+        get_entry(at, &tag, &dt);
+        rec_us += dt;
+
+        if (tag == MEB_RECORD_KEY)
+        {
+            uint64_t in;
+            get_varint(at, &in);
+            MEBStats::Get()->InputArrived();
+            if (key_cb)
+                key_cb((int)in);
+        }
+        else if (tag == MEB_RECORD_SIZE)
+        {
+            uint64_t c, r;
+            get_varint(at, &c);
+            get_varint(at, &r);
+            rec_cols = c;
+            rec_rows = r;
+        }
+        else
+        {
+            get_frame(at, true);
+            played++;
+            break;
+        }
+    }
+    MEBScreen::Get()->EndFrame();
+
+    return true;
+}
+
+// Starts again from the beginning.
+void MEBReplay::Rewind()
+{
+    at = start;
+    rec_us = 0;
+    played = 0;
+    wall_us = MEBStats::Get()->Now();
+}
+
+// FOR INTERNAL USE ONLY
+bool MEBReplay::get_varint(const uint8_t *&p, uint64_t *v)
+{
+    uint64_t x = 0;
+    for (int shift = 0; p < end && shift < 64; shift += 7)
+    {
+        uint8_t b = *p++;
+        x |= (uint64_t)(b & 0x7f) << shift;
+        if (!(b & 0x80))
+        {
+            *v = x;
+            return true;
+        }
+    }
+    return false;
+}
+
+// FOR INTERNAL USE ONLY
+bool MEBReplay::get_entry(const uint8_t *&p, char *tag, uint64_t *dt)
+{
+    if (p >= end)
+        return false;
+    *tag = *p++;
+    return get_varint(p, dt);
+}
+
+// FOR INTERNAL USE ONLY
+// Reads a frame's spans, drawing them into the target window if asked. Returns false if the frame is cut short.
+bool MEBReplay::get_frame(const uint8_t *&p, bool draw)
+{
+    WINDOW *win = draw ? target->win : nullptr;
+    int wy0 = 0, wx0 = 0, wrows = 0, wcols = 0;
+    if (win != nullptr)
+    {
+        getbegyx(win, wy0, wx0);
+        getmaxyx(win, wrows, wcols);
+    }
+
+    uint64_t n_spans;
+    if (!get_varint(p, &n_spans))
+        return false;
+
+    for (uint64_t i = 0; i < n_spans; i++)
+    {
+        uint64_t y, x, n;
+        if (!get_varint(p, &y) || !get_varint(p, &x) || !get_varint(p, &n) || n > MEB_RECORD_MAX_SPAN)
+            return false;
+
+        line.resize(n);
+        uint64_t filled = 0;
+        while (filled < n)
+        {
+            uint64_t run, attr;
+            if (!get_varint(p, &run) || !get_varint(p, &attr))
+                return false;
+
+            uint64_t count = run >> 1;
+            bool repeated = run & 1;
+            if (count == 0 || count > n - filled || p + (repeated ? 1 : count) > end)
+                return false;
+
+            chtype a = (chtype)(attr << NCURSES_ATTR_SHIFT);
+            if (repeated)
+                std::fill(&line[filled], &line[filled] + count, a | *p++);
+            else
+                for (uint64_t k = 0; k < count; k++)
+                    line[filled + k] = a | *p++;
+            filled += count;
+        }
+
+        if (win == nullptr)
+            continue;
+
+        // Recorded at screen coordinates, drawn relative to the window.
+        int wy = (int)y - wy0;
+        int lo = std::max((int)x - wx0, 0);
+        int hi = std::min((int)(x + n) - wx0, wcols);
+        if (wy < 0 || wy >= wrows || lo >= hi)
+            continue;
+        mvwaddchnstr(win, wy, lo, &line[lo - ((int)x - wx0)], hi - lo);
+    }
+
+    return true;
+}
+
+// FOR INTERNAL USE ONLY
+// Checks every entry, counts the frames and keys, and leaves off any entry cut short by a recorder that did not exit cleanly.
+bool MEBReplay::scan()
+{
+    start = map + MEB_RECORD_MAGIC_LEN;
+    end = map + map_len;
+    total_frames = 0;
+    total_keys = 0;
+    duration = 0;
+
+    const uint8_t *p = start;
+    const uint8_t *whole = start;
+    while (p < end)
+    {
+        char tag;
+        uint64_t dt, v;
+        if (!get_entry(p, &tag, &dt))
+            break;
+
+        bool ok;
+        if (tag == MEB_RECORD_KEY)
+        {
+            ok = get_varint(p, &v);
+            total_keys += ok;
+        }
+        else if (tag == MEB_RECORD_SIZE)
+            ok = get_varint(p, &v) && get_varint(p, &v);
+        else if (tag == MEB_RECORD_FRAME)
+        {
+            ok = get_frame(p, false);
+            total_frames += ok;
+        }
+        else
+            return false;
+
+        if (!ok)
+            break;
+        // The first entry's time counts from when the recorder was made.
+        if (whole != start)
+            duration += dt;
+        whole = p;
+    }
+
+    end = whole;
+    return true;
+}
+
+// FOR INTERNAL USE ONLY
+// Plays every entry that is due, then waits for the next.
+void MEBReplay::tick()
+{
+    timer = -1;
+    uint64_t now = MEBStats::Get()->Now();
+
+    if (speed == 0)
+        Step();
+    else
+    {
+        // Whatever has fallen due is played at once; its frames are output together, when the loop's frame ends.
+        while (!Done())
+        {
+            const uint8_t *p = at;
+            char tag;
+            uint64_t dt;
+            get_entry(p, &tag, &dt);
+            uint64_t due = wall_us + (uint64_t)((rec_us + dt) / speed);
+            if (due > now)
+            {
+                timer = loop->AddTimer(std::max((int)((due - now) / 1000), 1), [this]()
+                                       { tick(); },
+                                       false);
+                return;
+            }
+            Step();
+        }
+    }
+
+    if (!Done())
+        timer = loop->AddTimer(1, [this]()
+                               { tick(); },
+                               false);
+}
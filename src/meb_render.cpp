@@ -0,0 +1,505 @@
+/**
+ * @file meb_render.cpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief A double-buffered terminal renderer which can stand in for NCURSES' own screen update.
+ * @version See Git tags for version information.
+ * @date 2026.10.16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <ncurses.h>
+#include <menu.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <stdlib.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <algorithm>
+#include <string>
+
+#include "mebgui.hpp"
+#include "meb_cells.hpp"
+#include "meb_render.hpp"
+#include "meb_stats.hpp"
+
+// Last, as it defines a macro for every terminfo capability.
+#include <term.h>
+
+// FOR INTERNAL USE ONLY
+// Whether the terminal has a capability; those it lacks are NULL, and those cancelled -1.
+static bool available(const char *cap)
+{
+    return cap != NULL && cap != (const char *)-1;
+}
+
+// Creates a renderer for the screen NCURSES is driving.
+MEBRenderer::MEBRenderer(int fd)
+{
+    this->fd = fd;
+    this->full = false;
+    this->cur_y = -1;
+    this->cur_x = -1;
+    this->cur_attr = A_NORMAL;
+
+    this->budget = MEB_RENDER_DEFAULT_BUDGET;
+    this->link_rate = 0;
+    this->rate_est = 0;
+    this->model = 0;
+    this->taken = 0;
+    this->backlogged = false;
+    this->measured_us = 0;
+    this->in_flight = 0;
+    this->behind = false;
+
+    // A description of its own, since making fd non-blocking would also affect input read from the same terminal.
+    this->out_fd = fd;
+    const char *tty = ttyname(fd);
+    if (tty != NULL)
+    {
+        int nb = open(tty, O_WRONLY | O_NONBLOCK | O_NOCTTY | O_CLOEXEC);
+        if (nb >= 0)
+            this->out_fd = nb;
+    }
+
+    // The terminal shows what NCURSES last output.
+    front.Resize(COLS, LINES);
+    front.Capture(curscr, 0, 0);
+}
+
+// Hands the terminal back to NCURSES.
+MEBRenderer::~MEBRenderer()
+{
+    // NCURSES writes to fd directly from here on, so nothing may be left to follow it.
+    while (!backlog.empty() && !full)
+    {
+        struct pollfd pfd = {out_fd, POLLOUT, 0};
+        poll(&pfd, 1, -1);
+        drain();
+    }
+    if (out_fd != fd)
+        close(out_fd);
+
+    // NCURSES' record of the terminal is out of date, so its next update repaints everything.
+    clearok(curscr, TRUE);
+}
+
+// Returns whether the terminal supports cursor addressing.
+bool MEBRenderer::Supported()
+{
+    return cursor_address != NULL;
+}
+
+// Outputs whatever changed in the NCURSES virtual screen since the last call.
+void MEBRenderer::Present()
+{
+    // The terminal will catch up with a later frame; what this one changed is then output along with it.
+    measure_link();
+    behind = budget > 0 && in_flight > budget;
+    if (behind)
+    {
+        MEBStats::Get()->counters.frames_dropped++;
+        return;
+    }
+
+    int rows, cols;
+    getmaxyx(newscr, rows, cols);
+
+    back.Resize(cols, rows);
+    back.Capture(newscr, 0, 0);
+    out.clear();
+
+    if (full || front.Cols() != cols || front.Rows() != rows)
+    {
+        // Cleared with normal attributes, so the background is not painted in some color.
+        set_attr(A_NORMAL);
+        emit(clear_screen);
+        cur_y = cur_x = 0;
+        front.Resize(cols, rows);
+        front.Clear();
+        full = false;
+        hints.clear();
+    }
+
+    for (size_t i = 0; i < hints.size(); i++)
+        scroll_band(hints[i].top, hints[i].bottom, hints[i].n);
+    hints.clear();
+
+    // Without the eat-newline glitch, writing the bottom-right cell would scroll the screen.
+    bool corner_scrolls = auto_right_margin && !eat_newline_glitch;
+
+    for (int r = 0; r < rows; r++)
+    {
+        int lo, hi;
+        if (!back.DiffRow(front, r, &lo, &hi))
+            continue;
+
+        if (corner_scrolls && r == rows - 1 && hi == cols - 1)
+        {
+            back.Put(cols - 1, r, front.Get(cols - 1, r));
+            if (--hi < lo)
+                continue;
+        }
+
+        put_span(r, lo, hi);
+    }
+
+    // Leave the terminal as NCURSES expects to find it.
+    move_to(getcury(curscr), getcurx(curscr));
+    set_attr(A_NORMAL);
+    untouchwin(newscr);
+
+    front.Swap(back);
+
+    backlog += out;
+    drain();
+}
+
+// Notes a band of rows whose content moved, for the next frame output.
+void MEBRenderer::ScrollHint(int top, int bottom, int n)
+{
+    if (n == 0 || top > bottom)
+        return;
+
+    // Frames dropped in between leave several scrolls of the same band, which add up to one.
+    if (!hints.empty() && hints.back().top == top && hints.back().bottom == bottom)
+    {
+        hints.back().n += n;
+        return;
+    }
+    if (hints.size() < MEB_RENDER_MAX_HINTS)
+        hints.push_back({top, bottom, n});
+}
+
+// Returns how long until the terminal is likely to take more output.
+int MEBRenderer::RetryMs()
+{
+    if (!Behind())
+        return -1;
+
+    double rate = Throughput();
+    if (rate <= 0)
+        return MEB_RENDER_RETRY_MS;
+
+    // Until the budget is met for a dropped frame, or else until the backlog is taken.
+    double bytes = behind ? in_flight - budget : backlog.size();
+    double ms = bytes * 1000.0 / rate;
+    return std::max(std::min((int)ceil(ms), 1000), 1);
+}
+
+// FOR INTERNAL USE ONLY
+// Estimates the bytes in flight and, if no rate was given, the link's throughput.
+void MEBRenderer::measure_link()
+{
+    drain();
+
+    uint64_t now = MEBStats::Get()->Now();
+    double dt = measured_us != 0 ? (now - measured_us) / 1e6 : 0;
+    measured_us = now;
+
+    // A terminal which was refusing output took it as fast as the link carried it, or a little slower if it caught up.
+    if (link_rate == 0 && backlogged && dt > 0)
+        rate_est = rate_est > 0 ? 0.875 * rate_est + 0.125 * taken / dt : taken / dt;
+    backlogged = !backlog.empty();
+    taken = 0;
+
+    model = Throughput() > 0 ? std::max(model - Throughput() * dt, 0.0) : 0;
+
+    // Pseudo-terminals always report an empty queue.
+    int q = 0;
+    if (ioctl(out_fd, TIOCOUTQ, &q) < 0)
+        q = 0;
+
+    in_flight = backlog.size() + std::max((size_t)model, (size_t)q);
+}
+
+// FOR INTERNAL USE ONLY
+// Writes as much of the backlog as the terminal takes without waiting.
+void MEBRenderer::drain()
+{
+    size_t done = 0;
+    while (done < backlog.size())
+    {
+        ssize_t n = write(out_fd, backlog.data() + done, backlog.size() - done);
+        if (n >= 0)
+        {
+            done += n;
+            continue;
+        }
+
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+            break;
+        if (errno != EINTR)
+        {
+            // The terminal is gone; repaint everything should it come back.
+            backlog.clear();
+            done = 0;
+            full = true;
+            break;
+        }
+    }
+
+    backlog.erase(0, done);
+    taken += done;
+    model += done;
+}
+
+// FOR INTERNAL USE ONLY
+// Appends a capability, if the terminal has it.
+void MEBRenderer::emit(const char *s)
+{
+    if (available(s))
+        out += s;
+}
+
+// FOR INTERNAL USE ONLY
+void MEBRenderer::move_to(int y, int x)
+{
+    if (y == cur_y && x == cur_x)
+        return;
+
+    emit(tiparm(cursor_address, y, x));
+    cur_y = y;
+    cur_x = x;
+}
+
+// FOR INTERNAL USE ONLY
+// Changes the terminal's attributes, resetting them only when one must be turned off.
+void MEBRenderer::set_attr(attr_t attr)
+{
+    if (attr == cur_attr)
+        return;
+
+    attr_t old_video = cur_attr & (A_ATTRIBUTES & ~A_COLOR);
+    attr_t new_video = attr & (A_ATTRIBUTES & ~A_COLOR);
+    int old_pair = PAIR_NUMBER(cur_attr);
+    int new_pair = PAIR_NUMBER(attr);
+    bool reset = false;
+
+    if (old_video & ~new_video & ~A_ALTCHARSET)
+    {
+        if (old_video & A_ALTCHARSET)
+            emit(exit_alt_charset_mode);
+        emit(exit_attribute_mode);
+        old_video = A_NORMAL;
+        reset = true;
+    }
+    else if ((old_video & A_ALTCHARSET) && !(new_video & A_ALTCHARSET))
+    {
+        emit(exit_alt_charset_mode);
+        old_video &= ~A_ALTCHARSET;
+    }
+
+    // The capabilities name fields of the current terminal, so cannot be tabulated up front.
+    attr_t on = new_video & ~old_video;
+    if (on & A_STANDOUT)
+        emit(enter_standout_mode);
+    if (on & A_UNDERLINE)
+        emit(enter_underline_mode);
+    if (on & A_REVERSE)
+        emit(enter_reverse_mode);
+    if (on & A_BLINK)
+        emit(enter_blink_mode);
+    if (on & A_DIM)
+        emit(enter_dim_mode);
+    if (on & A_BOLD)
+        emit(enter_bold_mode);
+    if (on & A_INVIS)
+        emit(enter_secure_mode);
+    if (on & A_ALTCHARSET)
+        emit(enter_alt_charset_mode);
+
+    // Not every terminal resets colors along with attributes, so they are set again after a reset.
+    if (new_pair != old_pair || (reset && new_pair != 0))
+    {
+        short fg = -1, bg = -1;
+        if (new_pair != 0)
+            pair_content(new_pair, &fg, &bg);
+
+        const char *setf = set_a_foreground != NULL ? set_a_foreground : set_foreground;
+        const char *setb = set_a_background != NULL ? set_a_background : set_background;
+        if (fg < 0 || bg < 0)
+            emit(orig_pair);
+        if (fg >= 0 && setf != NULL)
+            emit(tiparm(setf, fg));
+        if (bg >= 0 && setb != NULL)
+            emit(tiparm(setb, bg));
+    }
+
+    cur_attr = attr;
+}
+
+// FOR INTERNAL USE ONLY
+// Writes the cells of one row from lo to hi, inclusive, skipping long runs which have not changed.
+void MEBRenderer::put_span(int y, int lo, int hi)
+{
+    const chtype *now = back.Row(y);
+    const chtype *was = front.Row(y);
+    int cols = back.Cols();
+
+    int c = lo;
+    while (c <= hi)
+    {
+        // Short unchanged runs are cheaper to write again than to move the cursor over.
+        int same = c;
+        while (same <= hi && now[same] == was[same])
+            same++;
+        if (same - c > MEB_RENDER_MAX_BRIDGE)
+        {
+            c = same;
+            continue;
+        }
+
+        move_to(y, c);
+        attr_t attr = now[c] & A_ATTRIBUTES;
+        set_attr(attr);
+
+        // Then every following cell with the same attributes, in one go.
+        size_t at = out.size();
+        out.resize(at + hi - c + 1);
+        char *p = &out[at];
+        int end = c;
+        while (end <= hi && (now[end] & A_ATTRIBUTES) == attr)
+        {
+            if (end > c && now[end] == was[end])
+            {
+                same = end;
+                while (same <= hi && now[same] == was[same])
+                    same++;
+                if (same - end > MEB_RENDER_MAX_BRIDGE)
+                    break;
+            }
+
+            int ch = now[end] & A_CHARTEXT;
+            *p++ = (ch < 32 || ch == 127) ? '?' : ch;
+            end++;
+        }
+        out.resize(p - out.data());
+
+        // Where the cursor ends up after writing the last column depends on the terminal.
+        cur_x += end - c;
+        if (cur_x >= cols)
+            cur_y = cur_x = -1;
+        c = end;
+    }
+}
+
+// FOR INTERNAL USE ONLY
+// Scrolls a band of rows on the terminal, if it can and that takes less output than repainting them.
+void MEBRenderer::scroll_band(int top, int bottom, int n)
+{
+    int rows = front.Rows();
+    top = std::max(top, 0);
+    bottom = std::min(bottom, rows - 1);
+    int m = abs(n);
+    if (n == 0 || m > bottom - top)
+        return;
+
+    bool region = available(change_scroll_region) &&
+                  (n > 0 ? available(parm_index) || available(scroll_forward) : available(parm_rindex) || available(scroll_reverse));
+    bool insdel = (available(parm_delete_line) || available(delete_line)) &&
+                  (available(parm_insert_line) || available(insert_line));
+    if (!region && !insdel)
+        return;
+
+    shifted = front;
+    shifted.ScrollRows(top, bottom, n);
+    size_t before = repaint_cost(front, top, bottom);
+    size_t after = repaint_cost(shifted, top, bottom);
+    if (after >= before)
+        return;
+
+    size_t mark = out.size();
+    int y = cur_y, x = cur_x;
+    attr_t attr = cur_attr;
+
+    // Rows scrolled in are blanked with the current background, which must be the default the front grid assumes.
+    set_attr(A_NORMAL);
+    if (region)
+    {
+        // Terminals differ in where setting the region leaves the cursor.
+        emit(tiparm(change_scroll_region, top, bottom));
+        cur_y = cur_x = -1;
+        if (n > 0)
+        {
+            move_to(bottom, 0);
+            emit_n(parm_index, scroll_forward, m);
+        }
+        else
+        {
+            move_to(top, 0);
+            emit_n(parm_rindex, scroll_reverse, m);
+        }
+        emit(tiparm(change_scroll_region, 0, rows - 1));
+    }
+    else if (n > 0)
+    {
+        // Deleting lines pulls up those below the band too; inserting as many at its foot pushes them back.
+        move_to(top, 0);
+        emit_n(parm_delete_line, delete_line, m);
+        move_to(bottom - m + 1, 0);
+        emit_n(parm_insert_line, insert_line, m);
+    }
+    else
+    {
+        move_to(bottom - m + 1, 0);
+        emit_n(parm_delete_line, delete_line, m);
+        move_to(top, 0);
+        emit_n(parm_insert_line, insert_line, m);
+    }
+    cur_y = cur_x = -1;
+
+    if (out.size() - mark + after >= before)
+    {
+        out.resize(mark);
+        cur_y = y;
+        cur_x = x;
+        cur_attr = attr;
+        return;
+    }
+
+    front.Swap(shifted);
+}
+
+// FOR INTERNAL USE ONLY
+// Counts the cells of a band of rows which differ between the frame and a grid of the same size.
+size_t MEBRenderer::repaint_cost(const MEBCellBuffer &prev, int top, int bottom)
+{
+    size_t cells = 0;
+    for (int r = top; r <= bottom; r++)
+    {
+        int lo, hi;
+        if (back.DiffRow(prev, r, &lo, &hi))
+            cells += hi - lo + 1;
+    }
+    return cells;
+}
+
+// FOR INTERNAL USE ONLY
+// Appends a capability taking a count, or else its single form that many times.
+void MEBRenderer::emit_n(const char *parm, const char *one, int n)
+{
+    if (available(parm) && (n > 1 || !available(one)))
+    {
+        emit(tiparm(parm, n));
+        return;
+    }
+    for (int i = 0; i < n; i++)
+        emit(one);
+}
@@ -0,0 +1,250 @@
+/**
+ * @file meb_scrollview.cpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief A scrolling view onto content larger than itself, drawn into an NCURSES pad.
+ * @version See Git tags for version information.
+ * @date 2026.10.16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <ncurses.h>
+#include <menu.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <stdexcept>
+
+#include "mebgui.hpp"
+#include "meb_scrollview.hpp"
+
+// Spawns a view onto blank content.
+MEBScrollView::MEBScrollView(MEBWindow *w, int x, int y, int cols, int rows, int content_cols, int content_rows)
+{
+    if (cols < 1 || rows < 1 || content_cols < 1 || content_rows < 1)
+        throw std::invalid_argument("Scroll view and its content must be at least one cell in size.");
+
+    this->pad = newpad(content_rows, content_cols);
+    if (pad == nullptr)
+        throw std::runtime_error("Failed to create pad.");
+
+    this->x = x;
+    this->y = y;
+    this->cols = cols;
+    this->rows = rows;
+    this->parent = w;
+    this->posted_win = nullptr;
+    this->sub = nullptr;
+
+    this->content_cols = content_cols;
+    this->content_rows = content_rows;
+    this->top = 0;
+    this->left = 0;
+    this->shown_top = 0;
+    this->shown_left = 0;
+    this->redraw = true;
+
+    Refresh();
+
+    MEBScreen::Get()->Register(this);
+}
+
+// Destroys the view and its content.
+MEBScrollView::~MEBScrollView()
+{
+    MEBScreen::Get()->Unregister(this);
+
+    if (sub != nullptr)
+    {
+        werase(sub);
+        wsyncup(sub);
+        delwin(sub);
+    }
+    delwin(pad);
+    MEBScreen::Get()->Present();
+}
+
+// Resizes the content, keeping what still fits.
+void MEBScrollView::SetContentSize(int cols, int rows)
+{
+    if (cols < 1 || rows < 1 || wresize(pad, rows, cols) != OK)
+        return;
+
+    content_cols = cols;
+    content_rows = rows;
+    redraw = true;
+    ScrollTo(top, left);
+}
+
+// Scrolls the view, stopping at the edges of the content.
+void MEBScrollView::Scroll(int drows, int dcols)
+{
+    ScrollTo(top + drows, left + dcols);
+}
+
+// Puts a cell of the content at the top-left of the view.
+void MEBScrollView::ScrollTo(int row, int col)
+{
+    top = std::max(std::min(row, content_rows - rows), 0);
+    left = std::max(std::min(col, content_cols - cols), 0);
+    MEBScreen::Get()->Present();
+}
+
+// Handles arrow keys, page up / page down and home / end scrolling.
+bool MEBScrollView::Update(int in)
+{
+    switch (in)
+    {
+    case KEY_UP:
+        Scroll(-1, 0);
+        return true;
+    case KEY_DOWN:
+        Scroll(1, 0);
+        return true;
+    case KEY_LEFT:
+        Scroll(0, -1);
+        return true;
+    case KEY_RIGHT:
+        Scroll(0, 1);
+        return true;
+    case KEY_PPAGE:
+        Scroll(-rows, 0);
+        return true;
+    case KEY_NPAGE:
+        Scroll(rows, 0);
+        return true;
+    case KEY_HOME:
+        ScrollTo(0, 0);
+        return true;
+    case KEY_END:
+        ScrollTo(content_rows, 0);
+        return true;
+    }
+
+    return false;
+}
+
+// Copies into the parent window the rows exposed by scrolling, and those drawn into.
+void MEBScrollView::Render()
+{
+    if (parent->win != nullptr && posted_win != parent->win)
+        Refresh();
+    if (sub == nullptr)
+        return;
+
+    bool changed = false;
+    int dy = top - shown_top;
+    if (redraw || left != shown_left || abs(dy) >= rows)
+    {
+        copy_rows(0, rows - 1);
+        changed = true;
+    }
+    else
+    {
+        if (dy != 0)
+        {
+            // The rows still in view keep their cells, moved along with them; only those exposed come from the pad.
+            scrollok(sub, TRUE);
+            wscrl(sub, dy);
+            scrollok(sub, FALSE);
+            if (dy > 0)
+                copy_rows(rows - dy, rows - 1);
+            else
+                copy_rows(0, -dy - 1);
+            MEBScreen::Get()->Scrolled(sub, dy);
+            changed = true;
+        }
+
+        for (int r = 0; r < rows && top + r < content_rows; r++)
+        {
+            if (is_linetouched(pad, top + r))
+            {
+                copy_rows(r, r);
+                changed = true;
+            }
+        }
+    }
+    untouchwin(pad);
+
+    redraw = false;
+    shown_top = top;
+    shown_left = left;
+    if (!changed)
+        return;
+
+    // The sub-window shares the parent's cells, but the parent must be told which of its lines changed.
+    wsyncup(sub);
+}
+
+// Moves the view some delta-position.
+void MEBScrollView::Move(int dx, int dy)
+{
+    counters.moves++;
+    x += dx;
+    y += dy;
+
+    Refresh();
+}
+
+// Recreates the view's sub-window and copies the whole view into it.
+void MEBScrollView::Refresh()
+{
+    if (sub != nullptr)
+    {
+        werase(sub);
+        delwin(sub);
+        sub = nullptr;
+    }
+
+    posted_win = parent->win;
+    if (parent->win != nullptr)
+        sub = derwin(parent->win, rows, cols, y, x);
+
+    redraw = true;
+    MEBScreen::Get()->Present();
+}
+
+// Deletes the sub-window if it was made from w.
+void MEBScrollView::Release(WINDOW *w)
+{
+    if (sub == nullptr || posted_win != w)
+        return;
+
+    delwin(sub);
+    sub = nullptr;
+    posted_win = nullptr;
+}
+
+// FOR INTERNAL USE ONLY
+// Copies rows of the view from the pad, blanking whatever lies past the edges of the content.
+void MEBScrollView::copy_rows(int first, int last)
+{
+    int width = std::min(cols, content_cols - left);
+    for (int r = first; r <= last; r++)
+    {
+        int from = 0;
+        if (top + r < content_rows)
+        {
+            copywin(pad, sub, top + r, left, r, 0, r, width - 1, FALSE);
+            from = width;
+        }
+        if (from < cols)
+        {
+            wmove(sub, r, from);
+            wclrtoeol(sub);
+        }
+    }
+}
@@ -0,0 +1,315 @@
+/**
+ * @file meb_search.cpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief A trigram index for incremental substring search over menu items.
+ * @version See Git tags for version information.
+ * @date 2026.10.16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <ncurses.h>
+#include <menu.h>
+#include <ctype.h>
+#include <string.h>
+#include <algorithm>
+
+#include "meb_search.hpp"
+
+#define MEB_SEARCH_BUCKETS 65536
+
+// Creates an empty index.
+MEBSearchIndex::MEBSearchIndex()
+{
+    n_items = 0;
+    quit = false;
+    job_ready = false;
+    busy = false;
+    job_all = false;
+    job_gen = 0;
+    complete = true;
+    generation = 0;
+    results_gen = 0;
+    text_off.push_back(0);
+    post_off.assign(MEB_SEARCH_BUCKETS + 1, 0);
+}
+
+// Stops the background thread.
+MEBSearchIndex::~MEBSearchIndex()
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        quit = true;
+    }
+    cv.notify_one();
+
+    if (thread.joinable())
+        thread.join();
+}
+
+// Indexes items supplied by a source.
+void MEBSearchIndex::Build(int n_items, MEBMenuSource source)
+{
+    // Built aside and swapped in under the lock, as a search may still be reading the current index.
+    std::vector<char> text;
+    std::vector<uint32_t> text_off(1, 0);
+    std::vector<uint32_t> post_off(MEB_SEARCH_BUCKETS + 1, 0);
+    std::vector<int> postings;
+    text_off.reserve(n_items + 1);
+
+    for (int i = 0; i < n_items; i++)
+    {
+        const char *title = NULL;
+        const char *desc = NULL;
+        source(i, &title, &desc);
+
+        for (const char *c = title; c != NULL && *c; c++)
+            text.push_back(tolower((unsigned char)*c));
+        text.push_back('\n');
+        for (const char *c = desc; c != NULL && *c; c++)
+            text.push_back(tolower((unsigned char)*c));
+
+        text_off.push_back(text.size());
+    }
+
+    // Two passes over every item's distinct buckets: count, then fill. Items are visited in order, so each bucket's
+    // list comes out sorted.
+    std::vector<uint32_t> count(MEB_SEARCH_BUCKETS, 0);
+    std::vector<uint32_t> seen;
+
+    for (int pass = 0; pass < 2; pass++)
+    {
+        for (int i = 0; i < n_items; i++)
+        {
+            seen.clear();
+            for (uint32_t o = text_off[i]; o + 3 <= text_off[i + 1]; o++)
+                seen.push_back(bucket((const unsigned char *)&text[o]));
+
+            std::sort(seen.begin(), seen.end());
+            seen.erase(std::unique(seen.begin(), seen.end()), seen.end());
+
+            for (size_t j = 0; j < seen.size(); j++)
+            {
+                if (pass == 0)
+                    count[seen[j]]++;
+                else
+                    postings[count[seen[j]]++] = i;
+            }
+        }
+
+        if (pass == 0)
+        {
+            post_off[0] = 0;
+            for (int b = 0; b < MEB_SEARCH_BUCKETS; b++)
+                post_off[b + 1] = post_off[b] + count[b];
+            postings.resize(post_off[MEB_SEARCH_BUCKETS]);
+
+            // Reuse the counts as fill cursors.
+            for (int b = 0; b < MEB_SEARCH_BUCKETS; b++)
+                count[b] = post_off[b];
+        }
+    }
+
+    // The bumped generation makes the worker abandon its search; it lets go of the index once it notices.
+    std::unique_lock<std::mutex> guard(lock);
+    results.clear();
+    results_query.clear();
+    results_gen = ++generation;
+    job_ready = false;
+    job_candidates.clear();
+    idle.wait(guard, [this]()
+              { return !busy; });
+
+    this->n_items = n_items;
+    this->text.swap(text);
+    this->text_off.swap(text_off);
+    this->post_off.swap(post_off);
+    this->postings.swap(postings);
+    complete = true;
+}
+
+void MEBSearchIndex::OnProgress(std::function<void()> cb)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    progress_cb = cb;
+}
+
+// Starts a search, superseding any search still running.
+void MEBSearchIndex::Query(const char *query)
+{
+    std::string q;
+    for (const char *c = query; *c; c++)
+        q.push_back(tolower((unsigned char)*c));
+
+    std::unique_lock<std::mutex> guard(lock);
+
+    uint64_t gen = ++generation;
+    bool all = false;
+    std::vector<int> candidates;
+
+    if (complete && !results_query.empty() && q.find(results_query) != std::string::npos)
+    {
+        // Anything matching q also matched the previous query; only its matches need checking.
+        candidates = results;
+    }
+    else if (q.size() >= 3)
+    {
+        // Intersect the postings of every trigram in the query, shortest first.
+        std::vector<uint32_t> buckets;
+        for (size_t o = 0; o + 3 <= q.size(); o++)
+            buckets.push_back(bucket((const unsigned char *)&q[o]));
+        std::sort(buckets.begin(), buckets.end(), [this](uint32_t a, uint32_t b)
+                  { return post_off[a + 1] - post_off[a] < post_off[b + 1] - post_off[b]; });
+
+        candidates.assign(postings.begin() + post_off[buckets[0]], postings.begin() + post_off[buckets[0] + 1]);
+        for (size_t j = 1; j < buckets.size() && !candidates.empty(); j++)
+        {
+            std::vector<int> merged;
+            std::set_intersection(candidates.begin(), candidates.end(),
+                                  postings.begin() + post_off[buckets[j]], postings.begin() + post_off[buckets[j] + 1],
+                                  std::back_inserter(merged));
+            candidates.swap(merged);
+        }
+    }
+    else
+    {
+        all = true;
+    }
+
+    results.clear();
+    results_gen = gen;
+    results_query = q;
+
+    size_t n_candidates = all ? (size_t)n_items : candidates.size();
+    if (n_candidates <= MEB_SEARCH_SYNC_LIMIT)
+    {
+        for (size_t j = 0; j < n_candidates; j++)
+        {
+            int item = all ? (int)j : candidates[j];
+            if (matches(item, q))
+                results.push_back(item);
+        }
+        complete = true;
+        return;
+    }
+
+    complete = false;
+    job_gen = gen;
+    job_query = q;
+    job_all = all;
+    job_candidates.swap(candidates);
+    job_ready = true;
+
+    if (!thread.joinable())
+        thread = std::thread(&MEBSearchIndex::worker, this);
+
+    guard.unlock();
+    cv.notify_one();
+}
+
+// Brings a copy of the results up to date.
+bool MEBSearchIndex::Fetch(std::vector<int> &out, uint64_t &generation)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    if (generation != results_gen)
+    {
+        out = results;
+        generation = results_gen;
+        return true;
+    }
+
+    if (out.size() < results.size())
+    {
+        out.insert(out.end(), results.begin() + out.size(), results.end());
+        return true;
+    }
+
+    return false;
+}
+
+// FOR INTERNAL USE ONLY
+uint32_t MEBSearchIndex::bucket(const unsigned char *p)
+{
+    uint32_t t = ((uint32_t)p[0] << 16) | ((uint32_t)p[1] << 8) | p[2];
+    return (t * 2654435761u) >> 16;
+}
+
+// FOR INTERNAL USE ONLY
+bool MEBSearchIndex::matches(int item, const std::string &q)
+{
+    uint32_t len = text_off[item + 1] - text_off[item];
+    return q.empty() || memmem(&text[text_off[item]], len, q.data(), q.size()) != NULL;
+}
+
+// FOR INTERNAL USE ONLY
+// Verifies large candidate sets, publishing matches a chunk at a time until done or superseded.
+void MEBSearchIndex::worker()
+{
+    std::unique_lock<std::mutex> guard(lock);
+
+    while (true)
+    {
+        cv.wait(guard, [this]()
+                { return quit || job_ready; });
+        if (quit)
+            return;
+
+        job_ready = false;
+        busy = true;
+        uint64_t gen = job_gen;
+        std::string q = job_query;
+        bool all = job_all;
+        std::vector<int> candidates;
+        candidates.swap(job_candidates);
+        size_t n_candidates = all ? (size_t)n_items : candidates.size();
+
+        guard.unlock();
+
+        std::vector<int> found;
+        for (size_t start = 0; start < n_candidates && generation == gen; start += MEB_SEARCH_CHUNK)
+        {
+            size_t end = std::min(start + MEB_SEARCH_CHUNK, n_candidates);
+
+            found.clear();
+            for (size_t j = start; j < end; j++)
+            {
+                int item = all ? (int)j : candidates[j];
+                if (matches(item, q))
+                    found.push_back(item);
+            }
+
+            std::function<void()> cb;
+            {
+                std::lock_guard<std::mutex> publish(lock);
+                if (results_gen != gen)
+                    break;
+                results.insert(results.end(), found.begin(), found.end());
+                if (end == n_candidates)
+                    complete = true;
+                cb = progress_cb;
+            }
+
+            if (cb && (!found.empty() || end == n_candidates))
+                cb();
+        }
+
+        guard.lock();
+        busy = false;
+        idle.notify_all();
+    }
+}
@@ -0,0 +1,448 @@
+/**
+ * @file meb_share.cpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Streams every frame to viewers attached over a Unix domain socket.
+ * @version See Git tags for version information.
+ * @date 2026.10.16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <ncurses.h>
+#include <menu.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <stdexcept>
+
+#include "mebgui.hpp"
+#include "meb_cells.hpp"
+#include "meb_eventloop.hpp"
+#include "meb_share.hpp"
+
+// Gaps in a row of changes up to this many cells are sent again rather than moved over.
+#define MEB_SHARE_MAX_BRIDGE 8
+// Queued frames handed to one sendmsg(...).
+#define MEB_SHARE_MAX_IOV 16
+
+// Listens for viewers.
+MEBShare::MEBShare(const char *path)
+{
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr.sun_path))
+        throw std::length_error("Socket path length exceeds maximum.");
+    strcpy(addr.sun_path, path);
+
+    this->path = path;
+    this->loop = nullptr;
+    this->timer = -1;
+    this->cur_attr = A_NORMAL;
+    this->frames = 0;
+    this->encoded = 0;
+    this->resyncs = 0;
+
+    // A socket nothing answers on was left behind by a process that has gone; one which answers is in use.
+    struct stat st;
+    if (lstat(path, &st) == 0 && S_ISSOCK(st.st_mode))
+    {
+        int probe = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        bool live = probe >= 0 && connect(probe, (struct sockaddr *)&addr, sizeof(addr)) == 0;
+        if (probe >= 0)
+            close(probe);
+        if (live)
+            throw std::runtime_error("Socket is already being shared to.");
+        unlink(path);
+    }
+
+    listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listen_fd < 0)
+        throw std::runtime_error("Cannot create socket.");
+    if (bind(listen_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(listen_fd, 8) < 0)
+    {
+        close(listen_fd);
+        throw std::runtime_error("Cannot listen on socket.");
+    }
+}
+
+// Disconnects every viewer and removes the socket.
+MEBShare::~MEBShare()
+{
+    while (!clients.empty())
+        drop(clients.size() - 1);
+
+    if (loop != nullptr)
+    {
+        loop->Unwatch(listen_fd);
+        if (timer >= 0)
+            loop->RemoveTimer(timer);
+    }
+
+    close(listen_fd);
+    unlink(path.c_str());
+}
+
+// Accepts viewers and retries queued output as the loop runs.
+void MEBShare::Attach(MEBEventLoop *loop)
+{
+    this->loop = loop;
+
+    loop->Watch(listen_fd, [this](int fd)
+                {
+                    // The new viewers are sent the whole screen with the next frame, so make one.
+                    size_t n = clients.size();
+                    accept_clients();
+                    if (clients.size() > n)
+                        MEBScreen::Get()->Present(); });
+
+    for (size_t i = 0; i < clients.size(); i++)
+        loop->Watch(clients[i].fd, [this](int fd)
+                    { on_client(fd); });
+}
+
+// Encodes what changed since the last frame and sends it to every viewer.
+void MEBShare::Broadcast()
+{
+    accept_clients();
+    if (clients.empty())
+        return;
+
+    int rows, cols;
+    getmaxyx(newscr, rows, cols);
+    back.Resize(cols, rows);
+    back.Capture(newscr, 0, 0);
+
+    // Every viewer is sent the whole of a resized screen.
+    bool resized = front.Cols() != cols || front.Rows() != rows;
+    if (resized)
+    {
+        front.Resize(cols, rows);
+        blank.Resize(cols, rows);
+        blank.Clear();
+    }
+
+    // Each encoding is made at most once, and only if some viewer is sent it.
+    frame diff, whole;
+    bool diffed = false;
+    for (size_t i = 0; i < clients.size(); i++)
+    {
+        client &c = clients[i];
+
+        if (c.queued > MEB_SHARE_MAX_BACKLOG)
+        {
+            // All but a partly sent frame, which must be finished so the viewer is not left inside an escape sequence.
+            size_t keep = c.sent > 0 ? 1 : 0;
+            c.queue.resize(keep);
+            c.queued = keep ? c.queue.front()->size() - c.sent : 0;
+            c.resync = true;
+        }
+
+        frame f;
+        if (c.resync || resized)
+        {
+            if (!whole)
+                whole = encode(blank);
+            f = whole;
+            c.resync = false;
+            resyncs++;
+        }
+        else
+        {
+            if (!diffed)
+            {
+                diff = encode(front);
+                diffed = true;
+            }
+            f = diff;
+        }
+
+        if (f)
+        {
+            c.queue.push_back(f);
+            c.queued += f->size();
+        }
+    }
+
+    front.Swap(back);
+    frames++;
+
+    flush_all();
+}
+
+// FOR INTERNAL USE ONLY
+void MEBShare::accept_clients()
+{
+    int fd;
+    while ((fd = accept4(listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0)
+    {
+        if (clients.size() >= MEB_SHARE_MAX_CLIENTS)
+        {
+            close(fd);
+            continue;
+        }
+
+        client c;
+        c.fd = fd;
+        c.sent = 0;
+        c.queued = 0;
+        c.resync = true;
+        clients.push_back(c);
+
+        if (loop != nullptr)
+            loop->Watch(fd, [this](int fd)
+                        { on_client(fd); });
+    }
+}
+
+// FOR INTERNAL USE ONLY
+// Viewers send nothing; anything they do is discarded, and end of file disconnects them.
+void MEBShare::on_client(int fd)
+{
+    char buf[256];
+    ssize_t n;
+    while ((n = read(fd, buf, sizeof(buf))) > 0)
+        ;
+
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+        return;
+
+    for (size_t i = 0; i < clients.size(); i++)
+    {
+        if (clients[i].fd == fd)
+        {
+            drop(i);
+            break;
+        }
+    }
+}
+
+// FOR INTERNAL USE ONLY
+void MEBShare::drop(size_t i)
+{
+    if (loop != nullptr)
+        loop->Unwatch(clients[i].fd);
+    close(clients[i].fd);
+    clients.erase(clients.begin() + i);
+}
+
+// FOR INTERNAL USE ONLY
+// Encodes the back grid's differences from another grid, leaving attributes normal at the end. Returns nullptr if none.
+MEBShare::frame MEBShare::encode(const MEBCellBuffer &was)
+{
+    std::shared_ptr<std::string> out = std::make_shared<std::string>();
+    bool whole = &was == &blank;
+    if (whole)
+        *out += "\x1b[0m\x1b(B\x1b[H\x1b[2J";
+    cur_attr = A_NORMAL;
+
+    int cols = back.Cols();
+    int cur_y = -1, cur_x = -1;
+    for (int r = 0; r < back.Rows(); r++)
+    {
+        int lo, hi;
+        if (!back.DiffRow(was, r, &lo, &hi))
+            continue;
+
+        const chtype *now = back.Row(r);
+        const chtype *old = was.Row(r);
+        int c = lo;
+        while (c <= hi)
+        {
+            int same = c;
+            while (same <= hi && now[same] == old[same])
+                same++;
+            if (same - c > MEB_SHARE_MAX_BRIDGE)
+            {
+                c = same;
+                continue;
+            }
+
+            if (r != cur_y || c != cur_x)
+            {
+                char cup[32];
+                snprintf(cup, sizeof(cup), "\x1b[%d;%dH", r + 1, c + 1);
+                *out += cup;
+            }
+
+            attr_t attr = now[c] & A_ATTRIBUTES;
+            if (attr != cur_attr)
+                put_attr(*out, attr);
+
+            int ch = now[c] & A_CHARTEXT;
+            *out += (ch < 32 || ch == 127) ? '?' : (char)ch;
+
+            c++;
+            cur_y = r;
+            cur_x = c < cols ? c : -1;
+        }
+    }
+
+    if (out->empty())
+        return frame();
+
+    if (cur_attr != A_NORMAL)
+        put_attr(*out, A_NORMAL);
+
+    encoded += out->size();
+    return out;
+}
+
+// FOR INTERNAL USE ONLY
+// Appends the sequences which change the attributes, color pair included, from cur_attr to attr.
+void MEBShare::put_attr(std::string &out, attr_t attr)
+{
+    bool was_acs = cur_attr & A_ALTCHARSET;
+    bool acs = attr & A_ALTCHARSET;
+    if (acs != was_acs)
+        out += acs ? "\x1b(0" : "\x1b(B"; // The DEC line-drawing set, in which NCURSES' ACS characters are given.
+
+    if ((cur_attr & ~A_ALTCHARSET) != (attr & ~A_ALTCHARSET))
+    {
+        // Reset, then set everything that is on.
+        char sgr[64] = "\x1b[0";
+        if (attr & A_BOLD)
+            strcat(sgr, ";1");
+        if (attr & A_DIM)
+            strcat(sgr, ";2");
+        if (attr & A_UNDERLINE)
+            strcat(sgr, ";4");
+        if (attr & A_BLINK)
+            strcat(sgr, ";5");
+        if (attr & (A_REVERSE | A_STANDOUT))
+            strcat(sgr, ";7");
+        if (attr & A_INVIS)
+            strcat(sgr, ";8");
+
+        short fg = -1, bg = -1;
+        if (PAIR_NUMBER(attr) != 0)
+            pair_content(PAIR_NUMBER(attr), &fg, &bg);
+
+        short colors[2] = {fg, bg};
+        for (int i = 0; i < 2; i++)
+        {
+            short n = colors[i];
+            size_t at = strlen(sgr);
+            if (n < 0)
+                continue;
+            else if (n < 8)
+                snprintf(sgr + at, sizeof(sgr) - at, ";%d", (i ? 40 : 30) + n);
+            else if (n < 16)
+                snprintf(sgr + at, sizeof(sgr) - at, ";%d", (i ? 100 : 90) + n - 8);
+            else
+                snprintf(sgr + at, sizeof(sgr) - at, ";%d;5;%d", i ? 48 : 38, n);
+        }
+
+        out += sgr;
+        out += 'm';
+    }
+
+    cur_attr = attr;
+}
+
+// FOR INTERNAL USE ONLY
+// Sends as much of a viewer's queue as it takes without waiting. The frames are shared, not copied.
+void MEBShare::flush(client &c)
+{
+    while (!c.queue.empty())
+    {
+        struct iovec iov[MEB_SHARE_MAX_IOV];
+        int n_iov = 0;
+        for (size_t i = 0; i < c.queue.size() && n_iov < MEB_SHARE_MAX_IOV; i++, n_iov++)
+        {
+            size_t skip = i == 0 ? c.sent : 0;
+            iov[n_iov].iov_base = (void *)(c.queue[i]->data() + skip);
+            iov[n_iov].iov_len = c.queue[i]->size() - skip;
+        }
+
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = iov;
+        msg.msg_iovlen = n_iov;
+
+        ssize_t n = sendmsg(c.fd, &msg, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+            {
+                // Gone; flush_all() disconnects it.
+                c.queue.clear();
+                c.queued = 0;
+                c.sent = 0;
+                c.fd = -c.fd - 1;
+            }
+            return;
+        }
+
+        c.queued -= n;
+        while (n > 0)
+        {
+            size_t left = c.queue.front()->size() - c.sent;
+            if ((size_t)n < left)
+            {
+                c.sent += n;
+                break;
+            }
+            n -= left;
+            c.queue.pop_front();
+            c.sent = 0;
+        }
+    }
+}
+
+// FOR INTERNAL USE ONLY
+// Sends what every viewer will take, disconnects those which are gone, and retries later if any did not take it all.
+void MEBShare::flush_all()
+{
+    bool waiting = false;
+    for (size_t i = clients.size(); i-- > 0;)
+    {
+        flush(clients[i]);
+        if (clients[i].fd < 0)
+        {
+            clients[i].fd = -clients[i].fd - 1;
+            drop(i);
+            continue;
+        }
+        waiting |= !clients[i].queue.empty();
+    }
+
+    if (waiting)
+        arm();
+    else if (timer >= 0)
+    {
+        loop->RemoveTimer(timer);
+        timer = -1;
+    }
+}
+
+// FOR INTERNAL USE ONLY
+void MEBShare::arm()
+{
+    if (loop == nullptr || timer >= 0)
+        return;
+
+    timer = loop->AddTimer(MEB_SHARE_RETRY_MS, [this]()
+                           { flush_all(); });
+}
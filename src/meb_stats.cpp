@@ -0,0 +1,425 @@
+/**
+ * @file meb_stats.cpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Rendering counters, frame statistics and a live overlay showing them.
+ * @version See Git tags for version information.
+ * @date 2026.10.16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <ncurses.h>
+#include <menu.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <algorithm>
+#include <string>
+
+#include "mebgui.hpp"
+#include "meb_stats.hpp"
+
+namespace
+{
+    void append(std::string &out, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+
+    void append(std::string &out, const char *fmt, ...)
+    {
+        char buf[256];
+        va_list args;
+        va_start(args, fmt);
+        int n = vsnprintf(buf, sizeof(buf), fmt, args);
+        va_end(args);
+        if (n > 0)
+            out.append(buf, std::min(n, (int)sizeof(buf) - 1));
+    }
+
+    // Quotes a label value as the exposition format requires.
+    std::string label(const char *value)
+    {
+        std::string s;
+        for (const char *p = value; *p != '\0'; p++)
+        {
+            if (*p == '\\' || *p == '"')
+                s.push_back('\\');
+            if (*p == '\n')
+            {
+                s += "\\n";
+                continue;
+            }
+            s.push_back(*p);
+        }
+        return s;
+    }
+
+    void counter(std::string &out, const char *name, const char *help, uint64_t value)
+    {
+        append(out, "# HELP %s %s\n# TYPE %s counter\n%s %llu\n", name, help, name, name, (unsigned long long)value);
+    }
+
+    void histogram(std::string &out, const char *name, const char *help, const MEBHistogram &h)
+    {
+        append(out, "# HELP %s %s\n# TYPE %s histogram\n", name, help, name);
+
+        uint64_t seen = 0;
+        for (int i = 0; i < MEB_STATS_BUCKETS - 1; i++)
+        {
+            seen += h.buckets[i];
+            append(out, "%s_bucket{le=\"%llu\"} %llu\n", name, 1ULL << i, (unsigned long long)seen);
+        }
+        append(out, "%s_bucket{le=\"+Inf\"} %llu\n", name, (unsigned long long)h.count);
+        append(out, "%s_sum %llu\n%s_count %llu\n", name, (unsigned long long)h.sum, name, (unsigned long long)h.count);
+    }
+
+    // Writes all of a string, or fails.
+    int write_all(int fd, const std::string &s)
+    {
+        size_t done = 0;
+        while (done < s.size())
+        {
+            ssize_t n = write(fd, s.data() + done, s.size() - done);
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n <= 0)
+                return -1;
+            done += n;
+        }
+        return 0;
+    }
+
+    // Finds "key: value" in /proc I/O accounting text.
+    bool field(const char *text, const char *key, uint64_t *value)
+    {
+        const char *p = strstr(text, key);
+        if (p == NULL)
+            return false;
+        *value = strtoull(p + strlen(key), NULL, 10);
+        return true;
+    }
+}
+
+// Counts a sample.
+void MEBHistogram::Add(uint64_t value)
+{
+    int i = 0;
+    while (i < MEB_STATS_BUCKETS - 1 && value > (1ULL << i))
+        i++;
+
+    buckets[i]++;
+    count++;
+    sum += value;
+    if (value > max)
+        max = value;
+}
+
+// Returns the upper bound of the bucket holding the given fraction of samples.
+uint64_t MEBHistogram::Percentile(double p) const
+{
+    if (count == 0)
+        return 0;
+
+    uint64_t target = (uint64_t)(p * count);
+    if (target < 1)
+        target = 1;
+
+    uint64_t seen = 0;
+    for (int i = 0; i < MEB_STATS_BUCKETS - 1; i++)
+    {
+        seen += buckets[i];
+        if (seen >= target)
+            return std::min(1ULL << i, (unsigned long long)max);
+    }
+    return max;
+}
+
+// Returns the one MEBStats.
+MEBStats *MEBStats::Get()
+{
+    static MEBStats stats;
+    return &stats;
+}
+
+MEBStats::MEBStats() : counters()
+{
+    enabled = false;
+    io_fd = -1;
+    frame_start = 0;
+    input_start = 0;
+    io_wchar = 0;
+    io_syscw = 0;
+}
+
+// Enables or disables timing and output measurement.
+void MEBStats::Enable(bool enable)
+{
+    if (enable && !enabled)
+    {
+        // Per-thread, so output written by other threads is not mistaken for the UI's.
+        io_fd = open("/proc/thread-self/io", O_RDONLY | O_CLOEXEC);
+    }
+    else if (!enable && io_fd >= 0)
+    {
+        close(io_fd);
+        io_fd = -1;
+    }
+
+    enabled = enable;
+    input_start = 0;
+}
+
+// Zeroes every counter.
+void MEBStats::Reset()
+{
+    counters = MEBScreenCounters();
+    input_start = 0;
+
+    const std::vector<MEBWindow *> &windows = MEBScreen::Get()->GetWindows();
+    for (size_t i = 0; i < windows.size(); i++)
+        windows[i]->counters = MEBCounters();
+
+    const std::vector<MEBWidget *> &widgets = MEBScreen::Get()->GetWidgets();
+    for (size_t i = 0; i < widgets.size(); i++)
+        widgets[i]->counters = MEBCounters();
+}
+
+// Writes every counter in the Prometheus text exposition format.
+void MEBStats::Format(std::string &out)
+{
+    counter(out, "meb_frames_total", "Physical screen updates.", counters.frames);
+    counter(out, "meb_refreshes_total", "Windows staged for output.", counters.refreshes);
+    counter(out, "meb_windows_created_total", "NCURSES windows created.", counters.windows_created);
+    counter(out, "meb_windows_destroyed_total", "NCURSES windows deleted.", counters.windows_destroyed);
+    counter(out, "meb_rows_culled_total", "Changed window rows hidden by windows above.", counters.rows_culled);
+    counter(out, "meb_frames_dropped_total", "Frames not output because the terminal was behind.", counters.frames_dropped);
+    counter(out, "meb_written_bytes_total", "Bytes written to the terminal while measuring.", counters.bytes_written);
+    counter(out, "meb_write_calls_total", "write() calls made to the terminal while measuring.", counters.write_calls);
+
+    histogram(out, "meb_frame_microseconds", "Time to render, compose and output a frame.", counters.frame_us);
+    histogram(out, "meb_frame_bytes", "Bytes written per frame.", counters.frame_bytes);
+    histogram(out, "meb_input_latency_microseconds", "Time from reading input to showing its effect.", counters.input_us);
+
+    const std::vector<MEBWindow *> &windows = MEBScreen::Get()->GetWindows();
+    const char *window_fields[] = {"refreshes", "moves", "resizes", "recreations"};
+    for (int f = 0; f < 4; f++)
+    {
+        append(out, "# TYPE meb_window_%s_total counter\n", window_fields[f]);
+        for (size_t i = 0; i < windows.size(); i++)
+        {
+            const MEBCounters &c = windows[i]->counters;
+            uint64_t v = f == 0 ? c.refreshes : f == 1 ? c.moves : f == 2 ? c.resizes : c.recreations;
+            append(out, "meb_window_%s_total{z=\"%zu\",title=\"%s\"} %llu\n", window_fields[f], i,
+                   label(windows[i]->GetTitle()).c_str(), (unsigned long long)v);
+        }
+    }
+
+    const std::vector<MEBWidget *> &widgets = MEBScreen::Get()->GetWidgets();
+    const char *widget_fields[] = {"renders", "render_microseconds", "moves"};
+    for (int f = 0; f < 3; f++)
+    {
+        append(out, "# TYPE meb_widget_%s_total counter\n", widget_fields[f]);
+        for (size_t i = 0; i < widgets.size(); i++)
+        {
+            const MEBCounters &c = widgets[i]->counters;
+            uint64_t v = f == 0 ? c.renders : f == 1 ? c.render_us : c.moves;
+            append(out, "meb_widget_%s_total{index=\"%zu\",kind=\"%s\"} %llu\n", widget_fields[f], i,
+                   label(widgets[i]->Name()).c_str(), (unsigned long long)v);
+        }
+    }
+}
+
+// Writes the counters to a file or a Unix domain socket.
+int MEBStats::Dump(const char *target)
+{
+    std::string text;
+    Format(text);
+
+    if (strncmp(target, "unix:", 5) == 0)
+    {
+        struct sockaddr_un addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        if (strlen(target + 5) >= sizeof(addr.sun_path))
+        {
+            errno = ENAMETOOLONG;
+            return -1;
+        }
+        strcpy(addr.sun_path, target + 5);
+
+        int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0)
+            return -1;
+
+        int ret = connect(fd, (struct sockaddr *)&addr, sizeof(addr));
+        if (ret == 0)
+            ret = write_all(fd, text);
+
+        int saved = errno;
+        close(fd);
+        errno = saved;
+        return ret;
+    }
+
+    std::string tmp = std::string(target) + ".tmp";
+    int fd = open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+        return -1;
+
+    int ret = write_all(fd, text);
+    int saved = errno;
+    close(fd);
+
+    if (ret == 0)
+        ret = rename(tmp.c_str(), target);
+    else
+    {
+        unlink(tmp.c_str());
+        errno = saved;
+    }
+    return ret;
+}
+
+// Returns the time in microseconds.
+uint64_t MEBStats::Now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+void MEBStats::FrameStarted()
+{
+    if (enabled)
+        frame_start = Now();
+}
+
+// Notes how much the UI thread had written before doupdate().
+void MEBStats::OutputStarted()
+{
+    if (enabled && !read_io(&io_wchar, &io_syscw))
+        io_wchar = io_syscw = 0;
+}
+
+void MEBStats::FrameFinished()
+{
+    counters.frames++;
+    if (!enabled)
+        return;
+
+    uint64_t now = Now();
+    counters.frame_us.Add(now - frame_start);
+
+    if (input_start != 0)
+    {
+        counters.input_us.Add(now - input_start);
+        input_start = 0;
+    }
+
+    uint64_t wchar, syscw;
+    if (io_wchar != 0 && read_io(&wchar, &syscw))
+    {
+        counters.bytes_written += wchar - io_wchar;
+        counters.write_calls += syscw - io_syscw;
+        counters.frame_bytes.Add(wchar - io_wchar);
+    }
+}
+
+// Latency is measured from the first input after a frame, since that is the one which waited longest.
+void MEBStats::InputArrived()
+{
+    if (enabled && input_start == 0)
+        input_start = Now();
+}
+
+// FOR INTERNAL USE ONLY
+// Reads the UI thread's cumulative written bytes and write calls.
+bool MEBStats::read_io(uint64_t *wchar, uint64_t *syscw)
+{
+    if (io_fd < 0)
+        return false;
+
+    char buf[512];
+    ssize_t n = pread(io_fd, buf, sizeof(buf) - 1, 0);
+    if (n <= 0)
+        return false;
+    buf[n] = '\0';
+
+    return field(buf, "wchar:", wchar) && field(buf, "syscw:", syscw);
+}
+
+// Opens the overlay and enables MEBStats.
+MEBStatsHUD::MEBStatsHUD(int x, int y)
+{
+    MEBStats::Get()->Enable(true);
+
+    this->window = new MEBWindow(x, y, 40, 9, "Stats");
+    this->drawn_at = 0;
+    this->drawn_frames = 0;
+
+    MEBScreen::Get()->Register(this);
+}
+
+// Closes the overlay. MEBStats stays enabled.
+MEBStatsHUD::~MEBStatsHUD()
+{
+    MEBScreen::Get()->Unregister(this);
+    delete window;
+}
+
+// Redraws the figures, at most every MEB_STATS_HUD_MS.
+void MEBStatsHUD::Render()
+{
+    MEBStats *stats = MEBStats::Get();
+    const MEBScreenCounters &c = stats->Counters();
+
+    uint64_t now = stats->Now();
+    if (window->win == nullptr || now - drawn_at < MEB_STATS_HUD_MS * 1000)
+        return;
+
+    double fps = drawn_at == 0 ? 0 : (c.frames - drawn_frames) * 1e6 / (now - drawn_at);
+    drawn_at = now;
+    drawn_frames = c.frames;
+
+    const MEBHistogram &f = c.frame_us;
+    const MEBHistogram &in = c.input_us;
+    const MEBHistogram &b = c.frame_bytes;
+    char lines[7][64];
+
+    snprintf(lines[0], sizeof(lines[0]), "%-8s%7s%7s%7s", "", "p50", "p99", "max");
+    snprintf(lines[1], sizeof(lines[1]), "%-8s%7llu%7llu%7llu us", "frame",
+             (unsigned long long)f.Percentile(0.5), (unsigned long long)f.Percentile(0.99), (unsigned long long)f.max);
+    snprintf(lines[2], sizeof(lines[2]), "%-8s%7llu%7llu%7llu us", "input",
+             (unsigned long long)in.Percentile(0.5), (unsigned long long)in.Percentile(0.99), (unsigned long long)in.max);
+    snprintf(lines[3], sizeof(lines[3]), "%-8s%7llu%7llu%7llu B", "output",
+             (unsigned long long)b.Percentile(0.5), (unsigned long long)b.Percentile(0.99), (unsigned long long)b.max);
+    snprintf(lines[4], sizeof(lines[4]), "%-8s%7.1f /s", "frames", fps);
+    // Writes are only counted while enabled, in the same frames as the output histogram.
+    snprintf(lines[5], sizeof(lines[5]), "%-8s%7.2f /frame", "writes", b.count ? (double)c.write_calls / b.count : 0.0);
+    snprintf(lines[6], sizeof(lines[6]), "%-8s%7llu made, %llu freed", "windows", (unsigned long long)c.windows_created,
+             (unsigned long long)c.windows_destroyed);
+
+    // Padded to the full width, so longer figures drawn before are overwritten without touching the border.
+    int width = window->Cols() - 4;
+    for (int r = 0; r < 7; r++)
+        mvwprintw(window->win, r + 1, 2, "%-*.*s", width, width, lines[r]);
+}
@@ -0,0 +1,707 @@
+/**
+ * @file meb_table.cpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief A scrolling table of typed columns, drawing only the cells in view which changed.
+ * @version See Git tags for version information.
+ * @date 2026.10.16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <ncurses.h>
+#include <menu.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+
+#include "mebgui.hpp"
+#include "meb_eventloop.hpp"
+#include "meb_stats.hpp"
+#include "meb_table.hpp"
+
+// Spawns an empty table.
+MEBTable::MEBTable(MEBWindow *w, int x, int y, int cols, int rows)
+{
+    if (rows < 2)
+        throw std::invalid_argument("Table needs a header row and at least one row of data.");
+
+    this->x = x;
+    this->y = y;
+    this->cols = cols;
+    this->rows = rows;
+    this->parent = w;
+    this->posted_win = nullptr;
+    this->sub = nullptr;
+    this->loop = nullptr;
+
+    this->n_rows = 0;
+
+    this->sorted = false;
+    this->sort_col = -1;
+    this->sort_desc = false;
+    this->sort_stale = false;
+    this->sort_running = false;
+    this->sort_gen = 0;
+    this->sort_started_us = 0;
+
+    this->top = 0;
+    this->left = 0;
+    this->redraw = true;
+    this->n_dirty = 0;
+
+    this->quit = false;
+    this->job_ready = false;
+    this->job_gen = 0;
+    this->job_type = MEB_COLUMN_INT;
+    this->job_desc = false;
+    this->result_ready = false;
+    this->result_gen = 0;
+
+    Refresh();
+
+    MEBScreen::Get()->Register(this);
+}
+
+// Stops the background thread.
+MEBTable::~MEBTable()
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        quit = true;
+    }
+    cv.notify_one();
+
+    if (thread.joinable())
+        thread.join();
+
+    MEBScreen::Get()->Unregister(this);
+
+    if (sub != nullptr)
+    {
+        werase(sub);
+        wsyncup(sub);
+        delwin(sub);
+    }
+    MEBScreen::Get()->Present();
+}
+
+// Wakes the loop when a background sort finishes.
+void MEBTable::Attach(MEBEventLoop *loop)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    this->loop = loop;
+}
+
+// Adds a column to the right of the others.
+int MEBTable::AddColumn(const char *name, MEBColumnType type, int width, const char *fmt /* = nullptr */)
+{
+    if (width < 1 || width > MEB_TABLE_CELL_MAX)
+        throw std::invalid_argument("Column width out of range.");
+
+    column c;
+    c.name = name != nullptr ? name : "";
+    c.type = type;
+    c.width = width;
+    if (fmt != nullptr)
+        c.fmt = fmt;
+    else
+        c.fmt = type == MEB_COLUMN_DOUBLE ? "%.2f" : "%lld";
+
+    switch (type)
+    {
+    case MEB_COLUMN_INT:
+        c.ints.resize(n_rows, 0);
+        break;
+    case MEB_COLUMN_DOUBLE:
+        c.reals.resize(n_rows, 0);
+        break;
+    case MEB_COLUMN_STRING:
+        c.strs.resize(n_rows);
+        break;
+    }
+    columns.push_back(c);
+
+    dirty.assign((size_t)(rows - 1) * columns.size(), 0);
+    n_dirty = 0;
+    layout_columns();
+    redraw = true;
+    MEBScreen::Get()->Present();
+
+    return columns.size() - 1;
+}
+
+// Adds or removes rows at the end.
+void MEBTable::SetRowCount(int n_rows)
+{
+    n_rows = std::max(n_rows, 0);
+    int old_rows = this->n_rows;
+    if (n_rows == old_rows)
+        return;
+
+    for (size_t c = 0; c < columns.size(); c++)
+    {
+        switch (columns[c].type)
+        {
+        case MEB_COLUMN_INT:
+            columns[c].ints.resize(n_rows, 0);
+            break;
+        case MEB_COLUMN_DOUBLE:
+            columns[c].reals.resize(n_rows, 0);
+            break;
+        case MEB_COLUMN_STRING:
+            columns[c].strs.resize(n_rows);
+            break;
+        }
+    }
+    this->n_rows = n_rows;
+
+    int body = rows - 1;
+    if (sort_col >= 0 && n_rows > old_rows)
+        sort_stale = true;
+
+    if (sorted && n_rows > old_rows)
+    {
+        // New rows go after the sorted ones until the next sort.
+        for (int r = old_rows; r < n_rows; r++)
+        {
+            rank.push_back(order.size());
+            order.push_back(r);
+        }
+    }
+    else if (sorted)
+    {
+        order.erase(std::remove_if(order.begin(), order.end(), [n_rows](int r)
+                                   { return r >= n_rows; }),
+                    order.end());
+        rank.resize(n_rows);
+        for (int p = 0; p < n_rows; p++)
+            rank[order[p]] = p;
+        redraw = true;
+    }
+
+    // Rows come or go only at the end of the display order, unless a sorted table shrank.
+    int old_top = top;
+    top = std::max(std::min(top, n_rows - body), 0);
+    if (top != old_top || std::min(old_rows, n_rows) < top + body)
+        redraw = true;
+
+    if (redraw)
+        MEBScreen::Get()->Present();
+}
+
+// Adds a row at the end.
+int MEBTable::AppendRow()
+{
+    SetRowCount(n_rows + 1);
+    return n_rows - 1;
+}
+
+// Sets a value in an integer column.
+void MEBTable::SetInt(int row, int col, int64_t value)
+{
+    column &c = cell_column(row, col, MEB_COLUMN_INT);
+    if (c.ints[row] == value)
+        return;
+
+    c.ints[row] = value;
+    changed(row, col);
+}
+
+// Sets a value in a floating-point column.
+void MEBTable::SetDouble(int row, int col, double value)
+{
+    column &c = cell_column(row, col, MEB_COLUMN_DOUBLE);
+    if (c.reals[row] == value)
+        return;
+
+    c.reals[row] = value;
+    changed(row, col);
+}
+
+// Sets a value in a text column.
+void MEBTable::SetString(int row, int col, const char *value)
+{
+    column &c = cell_column(row, col, MEB_COLUMN_STRING);
+    if (c.strs[row] == value)
+        return;
+
+    c.strs[row] = value;
+    changed(row, col);
+}
+
+int64_t MEBTable::GetInt(int row, int col)
+{
+    return cell_column(row, col, MEB_COLUMN_INT).ints[row];
+}
+
+double MEBTable::GetDouble(int row, int col)
+{
+    return cell_column(row, col, MEB_COLUMN_DOUBLE).reals[row];
+}
+
+const char *MEBTable::GetString(int row, int col)
+{
+    return cell_column(row, col, MEB_COLUMN_STRING).strs[row].c_str();
+}
+
+// Orders the rows by a column, in the background.
+void MEBTable::SortBy(int col, bool descending /* = false */)
+{
+    if (col >= (int)columns.size())
+        throw std::out_of_range("Column index out of range.");
+
+    sort_gen++;
+    sort_col = col;
+    sort_desc = descending;
+    sort_stale = false;
+    redraw = true; // For the header's marker.
+
+    if (col < 0)
+    {
+        sorted = false;
+        sort_running = false;
+        order.clear();
+        rank.clear();
+    }
+    else
+        start_sort();
+
+    MEBScreen::Get()->Present();
+}
+
+// Scrolls the view.
+void MEBTable::Scroll(int drows, int dcols)
+{
+    ScrollTo(top + drows, left + dcols);
+}
+
+// Scrolls the view to put a display position at the top and a column at the left.
+void MEBTable::ScrollTo(int pos, int col)
+{
+    pos = std::max(std::min(pos, n_rows - (rows - 1)), 0);
+    col = std::max(std::min(col, (int)columns.size() - 1), 0);
+    if (pos == top && col == left)
+        return;
+
+    top = pos;
+    left = col;
+    layout_columns();
+    redraw = true;
+    MEBScreen::Get()->Present();
+}
+
+// Handles scrolling keys.
+bool MEBTable::Update(int in)
+{
+    int body = rows - 1;
+    switch (in)
+    {
+    case KEY_UP:
+        Scroll(-1, 0);
+        return true;
+    case KEY_DOWN:
+        Scroll(1, 0);
+        return true;
+    case KEY_LEFT:
+        Scroll(0, -1);
+        return true;
+    case KEY_RIGHT:
+        Scroll(0, 1);
+        return true;
+    case KEY_PPAGE:
+        Scroll(-body, 0);
+        return true;
+    case KEY_NPAGE:
+        Scroll(body, 0);
+        return true;
+    case KEY_HOME:
+        ScrollTo(0, left);
+        return true;
+    case KEY_END:
+        ScrollTo(n_rows, left);
+        return true;
+    }
+
+    return false;
+}
+
+// Adopts a finished sort, starts another if the sorted column changed, and draws what changed.
+void MEBTable::Render()
+{
+    if (parent->win != nullptr && posted_win != parent->win)
+        Refresh();
+    if (sub == nullptr)
+        return;
+
+    adopt_sort();
+    if (sort_stale && !sort_running && MEBStats::Get()->Now() - sort_started_us >= MEB_TABLE_RESORT_MS * 1000)
+        start_sort();
+
+    int body = rows - 1;
+    int n_cols = columns.size();
+    if (redraw)
+    {
+        werase(sub);
+        draw_header();
+        for (int r = 0; r < body; r++)
+        {
+            for (int c = left; c < n_cols && col_x[c] >= 0; c++)
+                draw_cell(r, c, col_x[c]);
+        }
+        redraw = false;
+    }
+    else if (n_dirty > 0)
+    {
+        for (int r = 0; r < body; r++)
+        {
+            const uint8_t *d = &dirty[(size_t)r * n_cols];
+            for (int c = left; c < n_cols && col_x[c] >= 0; c++)
+            {
+                if (d[c])
+                    draw_cell(r, c, col_x[c]);
+            }
+        }
+    }
+    else
+        return;
+
+    if (n_dirty > 0)
+        std::fill(dirty.begin(), dirty.end(), 0);
+    n_dirty = 0;
+
+    // The sub-window shares the parent's cells, but the parent must be told which of its lines changed.
+    wsyncup(sub);
+}
+
+// Moves the table some delta-position.
+void MEBTable::Move(int dx, int dy)
+{
+    counters.moves++;
+    x += dx;
+    y += dy;
+
+    Refresh();
+}
+
+// Recreates the table's sub-window and redraws it.
+void MEBTable::Refresh()
+{
+    if (sub != nullptr)
+    {
+        werase(sub);
+        delwin(sub);
+        sub = nullptr;
+    }
+
+    posted_win = parent->win;
+    if (parent->win != nullptr)
+        sub = derwin(parent->win, rows, cols, y, x);
+
+    layout_columns();
+    redraw = true;
+    MEBScreen::Get()->Present();
+}
+
+// Deletes the sub-window if it was made from w.
+void MEBTable::Release(WINDOW *w)
+{
+    if (sub == nullptr || posted_win != w)
+        return;
+
+    delwin(sub);
+    sub = nullptr;
+    posted_win = nullptr;
+}
+
+// FOR INTERNAL USE ONLY
+// Returns a cell's column, checking the cell exists and holds the given type.
+MEBTable::column &MEBTable::cell_column(int row, int col, MEBColumnType type)
+{
+    if (row < 0 || row >= n_rows || col < 0 || col >= (int)columns.size())
+        throw std::out_of_range("Cell out of range.");
+    if (columns[col].type != type)
+        throw std::invalid_argument("Column holds another type.");
+
+    return columns[col];
+}
+
+// FOR INTERNAL USE ONLY
+// Marks a cell to be drawn with the next frame, if it is in view.
+void MEBTable::changed(int row, int col)
+{
+    if (col == sort_col)
+        sort_stale = true;
+
+    if (redraw)
+        return;
+
+    int pos = sorted ? rank[row] : row;
+    if (pos < top || pos >= top + rows - 1 || col_x[col] < 0)
+        return;
+
+    uint8_t &d = dirty[(size_t)(pos - top) * columns.size() + col];
+    if (d)
+        return;
+
+    d = 1;
+    if (n_dirty++ == 0)
+        MEBScreen::Get()->Present();
+}
+
+// FOR INTERNAL USE ONLY
+// Formats a cell into exactly its column's width. Numbers too wide to fit are shown as '#'.
+void MEBTable::format_cell(int row, int col, char *out)
+{
+    const column &c = columns[col];
+    char text[MEB_TABLE_CELL_MAX + 1];
+    int n = 0;
+
+    switch (c.type)
+    {
+    case MEB_COLUMN_INT:
+        n = snprintf(text, sizeof(text), c.fmt.c_str(), (long long)c.ints[row]);
+        break;
+    case MEB_COLUMN_DOUBLE:
+        n = snprintf(text, sizeof(text), c.fmt.c_str(), c.reals[row]);
+        break;
+    case MEB_COLUMN_STRING:
+    {
+        const std::string &s = c.strs[row];
+        n = std::min((int)s.size(), c.width);
+        for (int i = 0; i < n; i++)
+        {
+            unsigned char ch = s[i];
+            out[i] = (ch < ' ' || ch == 127) ? '?' : ch;
+        }
+        memset(out + n, ' ', c.width - n);
+        out[c.width] = '\0';
+        return;
+    }
+    }
+
+    n = std::max(n, 0);
+    if (n > c.width)
+        memset(out, '#', c.width);
+    else
+    {
+        memset(out, ' ', c.width - n);
+        memcpy(out + c.width - n, text, n);
+    }
+    out[c.width] = '\0';
+}
+
+// FOR INTERNAL USE ONLY
+// Works out where each column in view starts. Columns are separated by one blank cell.
+void MEBTable::layout_columns()
+{
+    col_x.assign(columns.size(), -1);
+
+    int cx = 0;
+    for (size_t c = left; c < columns.size() && cx < cols; c++)
+    {
+        col_x[c] = cx;
+        cx += columns[c].width + 1;
+    }
+}
+
+// FOR INTERNAL USE ONLY
+// Draws the column names, marking the sorted column with ^ (ascending) or v (descending).
+void MEBTable::draw_header()
+{
+    char buf[MEB_TABLE_CELL_MAX + 1];
+
+    wattron(sub, A_BOLD);
+    for (int c = left; c < (int)columns.size() && col_x[c] >= 0; c++)
+    {
+        const column &col = columns[c];
+        int n = std::min((int)col.name.size(), col.width);
+        memcpy(buf, col.name.data(), n);
+        memset(buf + n, ' ', col.width - n);
+        if (c == sort_col)
+            buf[col.width - 1] = sort_desc ? 'v' : '^';
+
+        mvwaddnstr(sub, 0, col_x[c], buf, std::min(col.width, cols - col_x[c]));
+    }
+    wattroff(sub, A_BOLD);
+}
+
+// FOR INTERNAL USE ONLY
+// Draws one cell of the body; r counts from the first row below the header.
+void MEBTable::draw_cell(int r, int col, int cx)
+{
+    char buf[MEB_TABLE_CELL_MAX + 1];
+    int width = columns[col].width;
+    int pos = top + r;
+
+    if (pos < n_rows)
+        format_cell(RowAt(pos), col, buf);
+    else
+    {
+        memset(buf, ' ', width);
+        buf[width] = '\0';
+    }
+
+    mvwaddnstr(sub, 1 + r, cx, buf, std::min(width, cols - cx));
+}
+
+// FOR INTERNAL USE ONLY
+// Hands a copy of the sorted column's keys to the background thread.
+void MEBTable::start_sort()
+{
+    const column &c = columns[sort_col];
+
+    std::vector<int64_t> ints;
+    std::vector<double> reals;
+    std::vector<std::string> strs;
+    switch (c.type)
+    {
+    case MEB_COLUMN_INT:
+        ints = c.ints;
+        break;
+    case MEB_COLUMN_DOUBLE:
+        reals = c.reals;
+        break;
+    case MEB_COLUMN_STRING:
+        strs = c.strs;
+        break;
+    }
+
+    sort_running = true;
+    sort_stale = false;
+    sort_started_us = MEBStats::Get()->Now();
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        job_gen = sort_gen;
+        job_type = c.type;
+        job_desc = sort_desc;
+        job_ints.swap(ints);
+        job_reals.swap(reals);
+        job_strs.swap(strs);
+        job_ready = true;
+
+        if (!thread.joinable())
+            thread = std::thread(&MEBTable::worker, this);
+    }
+    cv.notify_one();
+}
+
+// FOR INTERNAL USE ONLY
+// Shows a finished sort. Rows added since it started follow the sorted ones; rows removed are dropped.
+void MEBTable::adopt_sort()
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        if (!result_ready)
+            return;
+        result_ready = false;
+        if (result_gen != sort_gen)
+            return;
+        order.swap(result);
+    }
+
+    int sorted_rows = order.size();
+    if (sorted_rows > n_rows)
+    {
+        int n = n_rows;
+        order.erase(std::remove_if(order.begin(), order.end(), [n](int r)
+                                   { return r >= n; }),
+                    order.end());
+    }
+    for (int r = sorted_rows; r < n_rows; r++)
+        order.push_back(r);
+
+    rank.resize(n_rows);
+    for (int p = 0; p < n_rows; p++)
+        rank[order[p]] = p;
+
+    sorted = true;
+    sort_running = false;
+    redraw = true;
+}
+
+// FOR INTERNAL USE ONLY
+// Sorts row indices by a copy of their keys, publishing the order unless a newer sort was asked for meanwhile.
+void MEBTable::worker()
+{
+    std::unique_lock<std::mutex> guard(lock);
+
+    while (true)
+    {
+        cv.wait(guard, [this]()
+                { return quit || job_ready; });
+        if (quit)
+            return;
+
+        job_ready = false;
+        uint64_t gen = job_gen;
+        MEBColumnType type = job_type;
+        bool desc = job_desc;
+        std::vector<int64_t> ints;
+        std::vector<double> reals;
+        std::vector<std::string> strs;
+        ints.swap(job_ints);
+        reals.swap(job_reals);
+        strs.swap(job_strs);
+
+        guard.unlock();
+
+        size_t n = type == MEB_COLUMN_INT ? ints.size() : type == MEB_COLUMN_DOUBLE ? reals.size() : strs.size();
+        std::vector<int> idx(n);
+        std::iota(idx.begin(), idx.end(), 0);
+
+        // Stable, so rows with equal keys keep the order they were added in, whichever way the sort runs.
+        switch (type)
+        {
+        case MEB_COLUMN_INT:
+            std::stable_sort(idx.begin(), idx.end(), [&](int a, int b)
+                             { return desc ? ints[b] < ints[a] : ints[a] < ints[b]; });
+            break;
+        case MEB_COLUMN_DOUBLE:
+            // NaN sorts before every number, so the order stays strict.
+            std::stable_sort(idx.begin(), idx.end(), [&](int a, int b)
+                             {
+                                 double ka = desc ? reals[b] : reals[a];
+                                 double kb = desc ? reals[a] : reals[b];
+                                 return std::isnan(ka) ? !std::isnan(kb) : (!std::isnan(kb) && ka < kb); });
+            break;
+        case MEB_COLUMN_STRING:
+            std::stable_sort(idx.begin(), idx.end(), [&](int a, int b)
+                             { return desc ? strs[b] < strs[a] : strs[a] < strs[b]; });
+            break;
+        }
+
+        MEBEventLoop *wake = nullptr;
+        guard.lock();
+        if (gen == job_gen && !job_ready)
+        {
+            result.swap(idx);
+            result_gen = gen;
+            result_ready = true;
+            wake = loop;
+        }
+        guard.unlock();
+
+        if (wake != nullptr)
+            wake->Wakeup();
+
+        guard.lock();
+    }
+}
@@ -0,0 +1,578 @@
+/**
+ * @file meb_textview.cpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief A pager over a memory-mapped file of any size, indexing its lines on a background thread.
+ * @version See Git tags for version information.
+ * @date 2026.10.16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <ncurses.h>
+#include <menu.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <stdexcept>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "mebgui.hpp"
+#include "meb_eventloop.hpp"
+#include "meb_textview.hpp"
+
+namespace
+{
+    // Counts the line breaks in [p, end).
+    uint64_t count_lines(const char *p, const char *end)
+    {
+        uint64_t n = 0;
+
+#ifdef __SSE2__
+        const __m128i nl = _mm_set1_epi8('\n');
+        for (; p + 16 <= end; p += 16)
+        {
+            __m128i v = _mm_loadu_si128((const __m128i *)p);
+            n += __builtin_popcount(_mm_movemask_epi8(_mm_cmpeq_epi8(v, nl)));
+        }
+#endif
+
+        for (; p < end; p++)
+            n += *p == '\n';
+        return n;
+    }
+
+    // Returns where the line after the n-th line break in [p, end) starts, with n set to 0; or end, with n reduced by the breaks passed.
+    const char *skip_lines(const char *p, const char *end, uint64_t *n)
+    {
+        if (*n == 0)
+            return p;
+
+#ifdef __SSE2__
+        const __m128i nl = _mm_set1_epi8('\n');
+        for (; p + 16 <= end; p += 16)
+        {
+            __m128i v = _mm_loadu_si128((const __m128i *)p);
+            unsigned mask = _mm_movemask_epi8(_mm_cmpeq_epi8(v, nl));
+            unsigned c = __builtin_popcount(mask);
+            if (c < *n)
+            {
+                *n -= c;
+                continue;
+            }
+
+            // The n-th break is in this block; clear the ones before it.
+            for (; *n > 1; (*n)--)
+                mask &= mask - 1;
+            *n = 0;
+            return p + __builtin_ctz(mask) + 1;
+        }
+#endif
+
+        while (p < end)
+        {
+            const char *q = (const char *)memchr(p, '\n', end - p);
+            if (q == NULL)
+                return end;
+            p = q + 1;
+            if (--(*n) == 0)
+                return p;
+        }
+        return end;
+    }
+}
+
+// Maps a file and starts indexing it.
+MEBTextView::MEBTextView(MEBWindow *w, int x, int y, int cols, int rows, const char *path)
+{
+    if (cols < 1 || rows < 1)
+        throw std::invalid_argument("Text view must be at least one cell in size.");
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        throw std::runtime_error("Failed to open file.");
+
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+    {
+        close(fd);
+        throw std::runtime_error("Failed to stat file.");
+    }
+
+    this->map = nullptr;
+    this->size = st.st_size;
+    if (size > 0)
+    {
+        void *m = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (m == MAP_FAILED)
+        {
+            close(fd);
+            throw std::runtime_error("Failed to map file.");
+        }
+        this->map = (const char *)m;
+    }
+    close(fd);
+
+    this->x = x;
+    this->y = y;
+    this->cols = cols;
+    this->rows = rows;
+    this->parent = w;
+    this->posted_win = nullptr;
+    this->sub = nullptr;
+
+    this->top = 0;
+    this->top_line = 0;
+    this->left = 0;
+    this->numbers = false;
+    this->goto_line = -1;
+    this->scrolled = 0;
+    this->redraw = true;
+
+    this->quit = false;
+    this->pending = false;
+    this->loop = nullptr;
+    this->checkpoints.reserve(MEB_TEXTVIEW_MAX_CHECKPOINTS);
+    this->checkpoints.push_back(0);
+    this->stride = MEB_TEXTVIEW_STRIDE;
+    this->indexed_bytes = 0;
+    this->indexed_lines = 0;
+    this->complete = false;
+
+    this->thread = std::thread(&MEBTextView::worker, this);
+
+    Refresh();
+
+    MEBScreen::Get()->Register(this);
+}
+
+// Stops indexing and unmaps the file.
+MEBTextView::~MEBTextView()
+{
+    quit = true;
+    if (thread.joinable())
+        thread.join();
+
+    MEBScreen::Get()->Unregister(this);
+
+    if (sub != nullptr)
+    {
+        werase(sub);
+        wsyncup(sub);
+        delwin(sub);
+    }
+    if (map != nullptr)
+        munmap((void *)map, size);
+    MEBScreen::Get()->Present();
+}
+
+// Wakes the loop as indexing progresses.
+void MEBTextView::Attach(MEBEventLoop *loop)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    this->loop = loop;
+}
+
+// Scrolls the view.
+void MEBTextView::Scroll(int64_t dlines, int dcols)
+{
+    goto_line = -1;
+    if (size == 0)
+        dlines = 0;
+
+    for (; dlines > 0; dlines--)
+    {
+        const char *e = (const char *)memchr(map + top, '\n', size - top);
+        if (e == NULL || (uint64_t)(e + 1 - map) >= size)
+            break;
+        top = e + 1 - map;
+        if (top_line >= 0)
+            top_line++;
+        scrolled++;
+    }
+    for (; dlines < 0 && top > 0; dlines++)
+    {
+        top = line_start(top - 1);
+        if (top_line >= 0)
+            top_line--;
+        scrolled--;
+    }
+
+    left = std::max(left + dcols, 0);
+    redraw = true;
+    MEBScreen::Get()->Present();
+}
+
+// Puts a line at the top of the view.
+void MEBTextView::GoToLine(uint64_t line)
+{
+    uint64_t offset;
+    bool reached = offset_of(line, &offset);
+
+    top = offset;
+    top_line = -1;
+    goto_line = reached ? -1 : (int64_t)line;
+    scrolled = 0;
+    redraw = true;
+    MEBScreen::Get()->Present();
+}
+
+// Puts the line holding a byte at the top of the view.
+void MEBTextView::GoToOffset(uint64_t offset)
+{
+    top = size > 0 ? line_start(std::min(offset, size - 1)) : 0;
+    top_line = -1;
+    goto_line = -1;
+    scrolled = 0;
+    redraw = true;
+    MEBScreen::Get()->Present();
+}
+
+// Shows the last page of the file.
+void MEBTextView::GoToEnd()
+{
+    if (size == 0)
+        return;
+
+    // A break ending the file ends the last line rather than starting another.
+    uint64_t last = size - 1;
+    if (map[last] == '\n' && last > 0)
+        last--;
+    GoToOffset(last);
+    Scroll(-(rows - 1), 0);
+    scrolled = 0;
+}
+
+// Shows line numbers down the left side.
+void MEBTextView::SetLineNumbers(bool show)
+{
+    numbers = show;
+    redraw = true;
+    MEBScreen::Get()->Present();
+}
+
+// Handles arrow keys, page up / page down and home / end scrolling.
+bool MEBTextView::Update(int in)
+{
+    switch (in)
+    {
+    case KEY_UP:
+        Scroll(-1, 0);
+        return true;
+    case KEY_DOWN:
+        Scroll(1, 0);
+        return true;
+    case KEY_LEFT:
+        Scroll(0, -MEB_TEXTVIEW_TAB);
+        return true;
+    case KEY_RIGHT:
+        Scroll(0, MEB_TEXTVIEW_TAB);
+        return true;
+    case KEY_PPAGE:
+        Scroll(-rows, 0);
+        return true;
+    case KEY_NPAGE:
+        Scroll(rows, 0);
+        return true;
+    case KEY_HOME:
+        left = 0;
+        GoToOffset(0);
+        return true;
+    case KEY_END:
+        GoToEnd();
+        return true;
+    }
+
+    return false;
+}
+
+// Draws the lines in view if anything shown changed.
+void MEBTextView::Render()
+{
+    if (parent->win != nullptr && posted_win != parent->win)
+        Refresh();
+    if (sub == nullptr)
+        return;
+
+    // Progress only matters while a jump waits on it, or a line number shown is not yet known.
+    if (pending.exchange(false, std::memory_order_acq_rel))
+    {
+        if (goto_line >= 0)
+        {
+            uint64_t offset;
+            if (offset_of(goto_line, &offset))
+                goto_line = -1;
+            if (offset != top)
+            {
+                top = offset;
+                top_line = -1;
+                scrolled = 0;
+                redraw = true;
+            }
+        }
+        if (top_line < 0 || numbers)
+            redraw = true;
+    }
+    if (!redraw)
+        return;
+    redraw = false;
+
+    // Every row is drawn again, but a renderer can still scroll those which only moved rather than output them again.
+    if (scrolled != 0 && scrolled > -rows && scrolled < rows)
+        MEBScreen::Get()->Scrolled(sub, (int)scrolled);
+    scrolled = 0;
+
+    if (top_line < 0)
+        top_line = line_of(top);
+
+    werase(sub);
+
+    const char *p = map + top;
+    const char *end = map + size;
+    for (int r = 0; r < rows && p < end; r++)
+    {
+        const char *e = (const char *)memchr(p, '\n', end - p);
+        if (e == NULL)
+            e = end;
+        draw_line(r, p, e, top_line >= 0 ? top_line + r : -1);
+        p = e + 1;
+    }
+
+    // The sub-window shares the parent's cells, but the parent must be told which of its lines changed.
+    wsyncup(sub);
+}
+
+// Moves the view some delta-position.
+void MEBTextView::Move(int dx, int dy)
+{
+    counters.moves++;
+    x += dx;
+    y += dy;
+
+    Refresh();
+}
+
+// Recreates the view's sub-window and redraws it.
+void MEBTextView::Refresh()
+{
+    if (sub != nullptr)
+    {
+        werase(sub);
+        delwin(sub);
+        sub = nullptr;
+    }
+
+    posted_win = parent->win;
+    if (parent->win != nullptr)
+        sub = derwin(parent->win, rows, cols, y, x);
+
+    scrolled = 0;
+    redraw = true;
+    MEBScreen::Get()->Present();
+}
+
+// Deletes the sub-window if it was made from w.
+void MEBTextView::Release(WINDOW *w)
+{
+    if (sub == nullptr || posted_win != w)
+        return;
+
+    delwin(sub);
+    sub = nullptr;
+    posted_win = nullptr;
+}
+
+// Returns the number of the line at the top of the view.
+int64_t MEBTextView::GetTopLine()
+{
+    if (top_line < 0)
+        top_line = line_of(top);
+    return top_line;
+}
+
+// Returns the number of lines indexed so far.
+uint64_t MEBTextView::LineCount()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    return indexed_lines;
+}
+
+// Returns the number of bytes indexed so far.
+uint64_t MEBTextView::IndexedBytes()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    return indexed_bytes;
+}
+
+// FOR INTERNAL USE ONLY
+// Returns where the line holding a byte starts.
+uint64_t MEBTextView::line_start(uint64_t offset)
+{
+    const char *b = (const char *)memrchr(map, '\n', offset);
+    return b == NULL ? 0 : b + 1 - map;
+}
+
+// FOR INTERNAL USE ONLY
+// Returns the number of the line starting at an offset, counting from the checkpoint before it; -1 if not yet indexed.
+int64_t MEBTextView::line_of(uint64_t offset)
+{
+    uint64_t base, line;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        if (offset > indexed_bytes)
+            return -1;
+        size_t k = std::upper_bound(checkpoints.begin(), checkpoints.end(), offset) - checkpoints.begin() - 1;
+        base = checkpoints[k];
+        line = k * stride;
+    }
+    return line + count_lines(map + base, map + offset);
+}
+
+// FOR INTERNAL USE ONLY
+// Finds where a line starts, counting from the checkpoint before it. If it is not yet indexed, finds the last line
+// indexed instead and returns false.
+bool MEBTextView::offset_of(uint64_t line, uint64_t *offset)
+{
+    uint64_t base, rest;
+    bool reached;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        reached = complete || line < indexed_lines;
+        if (!reached)
+            line = indexed_lines;
+        size_t k = std::min((size_t)(line / stride), checkpoints.size() - 1);
+        base = checkpoints[k];
+        rest = line - k * stride;
+    }
+
+    const char *p = skip_lines(map + base, map + size, &rest);
+    // Past the last line, the last line.
+    if (rest > 0 || (uint64_t)(p - map) >= size)
+        p = map + (size > 0 ? line_start(size - 1 - (map[size - 1] == '\n' && size > 1)) : 0);
+    *offset = p - map;
+    return reached;
+}
+
+// FOR INTERNAL USE ONLY
+// Draws one line from the left scroll column, expanding tabs and showing other control characters as '?'.
+void MEBTextView::draw_line(int r, const char *s, const char *e, int64_t n)
+{
+    int width = cols;
+    if (numbers)
+    {
+        char num[32];
+        if (n >= 0)
+            snprintf(num, sizeof(num), "%*lld ", MEB_TEXTVIEW_GUTTER - 1, (long long)n + 1);
+        else
+            snprintf(num, sizeof(num), "%*s ", MEB_TEXTVIEW_GUTTER - 1, "?");
+        wattron(sub, A_DIM);
+        mvwaddnstr(sub, r, 0, num, std::min(cols, MEB_TEXTVIEW_GUTTER));
+        wattroff(sub, A_DIM);
+        width -= MEB_TEXTVIEW_GUTTER;
+        if (width <= 0)
+            return;
+    }
+
+    // Carriage returns ending a line are left out.
+    if (e > s && e[-1] == '\r')
+        e--;
+
+    line.clear();
+    int col = 0;
+    int right = left + width;
+    for (const char *p = s; p < e && col < right; p++)
+    {
+        unsigned char c = *p;
+        int n_cells = c == '\t' ? MEB_TEXTVIEW_TAB - col % MEB_TEXTVIEW_TAB : 1;
+        char shown = c == '\t' ? ' ' : (c >= 32 && c < 127) ? c : '?';
+        for (int k = 0; k < n_cells && col < right; k++, col++)
+            if (col >= left)
+                line += shown;
+    }
+
+    if (!line.empty())
+        mvwaddnstr(sub, r, cols - width, line.data(), line.size());
+}
+
+// FOR INTERNAL USE ONLY
+// Indexes the file a chunk at a time, publishing checkpoints after each.
+void MEBTextView::worker()
+{
+    const char *p = map;
+    const char *end = map + size;
+    uint64_t lines = 0;                   // Line breaks passed.
+    uint64_t next = MEB_TEXTVIEW_STRIDE; // Line at which the next checkpoint goes.
+    std::vector<uint64_t> found;
+
+    // Only this thread changes the stride, so it reads it without the lock.
+    while (p < end && !quit)
+    {
+        const char *chunk = p;
+        const char *chunk_end = p + std::min((uint64_t)(end - p), (uint64_t)MEB_TEXTVIEW_CHUNK);
+
+        found.clear();
+        while (p < chunk_end)
+        {
+            uint64_t n = next - lines;
+            p = skip_lines(p, chunk_end, &n);
+            lines = next - n;
+            if (n == 0)
+            {
+                found.push_back(p - map);
+                next += stride;
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            checkpoints.insert(checkpoints.end(), found.begin(), found.end());
+            if (checkpoints.size() > MEB_TEXTVIEW_MAX_CHECKPOINTS)
+            {
+                // Every other checkpoint, at twice the stride.
+                size_t kept = 0;
+                for (size_t k = 0; k < checkpoints.size(); k += 2)
+                    checkpoints[kept++] = checkpoints[k];
+                checkpoints.resize(kept);
+                stride *= 2;
+                next = kept * stride;
+            }
+            indexed_bytes = p - map;
+            indexed_lines = lines;
+            if (!pending.exchange(true, std::memory_order_acq_rel) && loop != nullptr)
+                loop->Wakeup();
+        }
+
+        // Read once; the view faults back in only the pages it shows.
+        madvise((void *)chunk, chunk_end - chunk, MADV_DONTNEED);
+    }
+
+    std::lock_guard<std::mutex> guard(lock);
+    if (p >= end)
+    {
+        // An unterminated last line is a line too.
+        indexed_lines = lines + (size > 0 && map[size - 1] != '\n');
+        complete = true;
+        if (!pending.exchange(true, std::memory_order_acq_rel) && loop != nullptr)
+            loop->Wakeup();
+    }
+}
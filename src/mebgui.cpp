@@ -26,20 +26,422 @@
 #include <menu.h>
 #include <pthread.h>
 #include <signal.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
 #include <unistd.h>
 #include <cstdlib>
 #include <stdexcept>
+#include <vector>
+#include <algorithm>
 
 // #include "meb_print.h"
 #include "mebgui.hpp"
 
+#include "meb_cells.hpp"
+#include "meb_layout.hpp"
+#include "meb_render.hpp"
+#include "meb_search.hpp"
+#include "meb_record.hpp"
+#include "meb_share.hpp"
+#include "meb_stats.hpp"
+
 #include "guimain.hpp"
 
+// Whether MEBWindows are updated in place (see MEBWindow::SetDamageTracking).
+static bool meb_damage_tracking = false;
+
+// The screen opened by ncurses_init_headless(...), and the streams standing in for its terminal.
+static SCREEN *meb_headless = nullptr;
+static FILE *meb_headless_out = nullptr;
+static FILE *meb_headless_in = nullptr;
+
+// The renderer made by ncurses_init(...) or ncurses_init_headless(...), if any.
+static MEBRenderer *meb_renderer = nullptr;
+
+// FOR INTERNAL USE ONLY
+// Switches frame output to a MEBRenderer writing to fd, if asked and the terminal allows.
+static void use_renderer(MEBRenderMode mode, int fd)
+{
+    if (mode != MEB_RENDER_NATIVE || !MEBRenderer::Supported())
+        return;
+
+    meb_renderer = new MEBRenderer(fd);
+    MEBScreen::Get()->SetRenderer(meb_renderer);
+}
+
+// Returns the one MEBScreen.
+MEBScreen *MEBScreen::Get()
+{
+    static MEBScreen screen;
+    return &screen;
+}
+
+MEBScreen::MEBScreen()
+{
+    frame_depth = 0;
+    renderer = nullptr;
+    share = nullptr;
+    recorder = nullptr;
+    layout = nullptr;
+    layout_cols = layout_rows = 0;
+}
+
+// Opens a frame; nested calls are counted.
+void MEBScreen::BeginFrame()
+{
+    frame_depth++;
+}
+
+// Closes a frame, flushing everything staged during it with a single physical update.
+void MEBScreen::EndFrame()
+{
+    if (frame_depth > 0)
+        frame_depth--;
+
+    if (frame_depth == 0)
+        Flush();
+}
+
+// Flushes staged output now, unless a frame is open.
+void MEBScreen::Present()
+{
+    if (frame_depth > 0)
+        return;
+
+    Flush();
+}
+
+// Registers a MEBWindow on top of all others.
+void MEBScreen::Register(MEBWindow *w)
+{
+    windows.push_back(w);
+}
+
+// Removes a MEBWindow.
+void MEBScreen::Unregister(MEBWindow *w)
+{
+    windows.erase(std::remove(windows.begin(), windows.end(), w), windows.end());
+}
+
+// Registers a widget to be rendered at the end of each frame.
+void MEBScreen::Register(MEBWidget *m)
+{
+    widgets.push_back(m);
+}
+
+// Removes a widget.
+void MEBScreen::Unregister(MEBWidget *m)
+{
+    widgets.erase(std::remove(widgets.begin(), widgets.end(), m), widgets.end());
+}
+
+// Has every widget let go of its sub-windows of w.
+void MEBScreen::Release(WINDOW *w)
+{
+    for (size_t i = 0; i < widgets.size(); i++)
+        widgets[i]->Release(w);
+}
+
+// Marks a screen rectangle as damaged, clipped to the screen.
+void MEBScreen::Damage(int x, int y, int cols, int rows)
+{
+    reset_damage(false);
+
+    int x0 = std::max(x, 0);
+    int x1 = std::min(x + cols, COLS) - 1;
+    int y0 = std::max(y, 0);
+    int y1 = std::min(y + rows, LINES) - 1;
+
+    for (int r = y0; r <= y1 && x0 <= x1; r++)
+    {
+        damage_lo[r] = std::min(damage_lo[r], x0);
+        damage_hi[r] = std::max(damage_hi[r], x1);
+    }
+}
+
+// Marks the part of rectangle a not covered by rectangle b as damaged.
+void MEBScreen::DamageExposed(const MEBRect &a, const MEBRect &b)
+{
+    int ix0 = std::max(a.x, b.x);
+    int iy0 = std::max(a.y, b.y);
+    int ix1 = std::min(a.x + a.cols, b.x + b.cols);
+    int iy1 = std::min(a.y + a.rows, b.y + b.rows);
+
+    if (ix0 >= ix1 || iy0 >= iy1)
+    {
+        Damage(a.x, a.y, a.cols, a.rows);
+        return;
+    }
+
+    // Bands above and below the overlap, then the strips left and right of it.
+    Damage(a.x, a.y, a.cols, iy0 - a.y);
+    Damage(a.x, iy1, a.cols, a.y + a.rows - iy1);
+    Damage(a.x, iy0, ix0 - a.x, iy1 - iy0);
+    Damage(ix1, iy0, a.x + a.cols - ix1, iy1 - iy0);
+}
+
+// Passes a window's scroll on to the renderer, if any.
+void MEBScreen::Scrolled(WINDOW *w, int n)
+{
+    if (renderer == nullptr || w == nullptr || n == 0)
+        return;
+
+    int top = getbegy(w);
+    renderer->ScrollHint(top, top + getmaxy(w) - 1, n);
+}
+
+// Copies the screen as composed so far into a cell grid.
+void MEBScreen::Snapshot(MEBCellBuffer &out)
+{
+    out.Resize(COLS, LINES);
+    out.Capture(stdscr, 0, 0);
+
+    for (size_t i = 0; i < windows.size(); i++)
+    {
+        WINDOW *w = windows[i]->win;
+        if (w == nullptr)
+            continue;
+
+        int wy, wx;
+        getbegyx(w, wy, wx);
+        out.Capture(w, wx, wy);
+    }
+}
+
+// FOR INTERNAL USE ONLY
+// Clears the damage spans, or only (re)sizes them to the screen if force is false.
+void MEBScreen::reset_damage(bool force)
+{
+    if (force || (int)damage_lo.size() != LINES)
+    {
+        damage_lo.assign(LINES, COLS);
+        damage_hi.assign(LINES, -1);
+    }
+}
+
+// FOR INTERNAL USE ONLY
+// Renders widgets, composes the virtual screen and performs the one physical update.
+void MEBScreen::Flush()
+{
+    MEBStats *stats = MEBStats::Get();
+    stats->FrameStarted();
+
+    // Widgets may stage output while rendering; hold the frame open so that is folded into this update.
+    frame_depth++;
+    place_windows();
+    for (size_t i = 0; i < widgets.size(); i++)
+    {
+        MEBWidget *m = widgets[i];
+        m->counters.renders++;
+        if (stats->Enabled())
+        {
+            uint64_t start = stats->Now();
+            m->Render();
+            m->counters.render_us += stats->Now() - start;
+        }
+        else
+            m->Render();
+    }
+    frame_depth--;
+
+    compose();
+    if (share != nullptr)
+        share->Broadcast();
+    if (recorder != nullptr)
+        recorder->Frame();
+
+    stats->OutputStarted();
+    if (renderer != nullptr)
+        renderer->Present();
+    else
+        doupdate();
+    stats->FrameFinished();
+}
+
+// Moves a window, and its descendants, above all others.
+void MEBScreen::Raise(MEBWindow *w)
+{
+    restack(w, true);
+}
+
+// Moves a window, and its descendants, beneath all others.
+void MEBScreen::Lower(MEBWindow *w)
+{
+    restack(w, false);
+}
+
+// FOR INTERNAL USE ONLY
+// Moves a window's subtree to the top or bottom of the stack, keeping its order, and repairs the area it covers.
+void MEBScreen::restack(MEBWindow *w, bool top)
+{
+    std::vector<MEBWindow *> subtree, rest;
+    for (size_t i = 0; i < windows.size(); i++)
+        (w->Contains(windows[i]) ? subtree : rest).push_back(windows[i]);
+
+    if (top)
+        rest.insert(rest.end(), subtree.begin(), subtree.end());
+    else
+        rest.insert(rest.begin(), subtree.begin(), subtree.end());
+    windows.swap(rest);
+
+    for (size_t i = 0; i < subtree.size(); i++)
+    {
+        WINDOW *sw = subtree[i]->win;
+        if (sw == nullptr)
+            continue;
+
+        int y, x, rows, cols;
+        getbegyx(sw, y, x);
+        getmaxyx(sw, rows, cols);
+        Damage(x, y, cols, rows);
+    }
+
+    Present();
+}
+
+// Lays the screen out with a MEBLayout from the next frame on.
+void MEBScreen::SetLayout(MEBLayout *root)
+{
+    layout = root;
+    layout_cols = layout_rows = 0;
+    Present();
+}
+
+// FOR INTERNAL USE ONLY
+// Applies the layout if the screen was resized or it changed, then places every window whose ancestors moved or
+// resized. Parents are beneath their children, so a single pass down the stack reaches each window after its parent.
+void MEBScreen::place_windows()
+{
+    if (layout != nullptr && (layout->NeedsApply() || layout_cols != COLS || layout_rows != LINES))
+    {
+        MEBRect r = {0, 0, COLS, LINES};
+        layout_cols = COLS;
+        layout_rows = LINES;
+        layout->Apply(r);
+    }
+
+    for (size_t i = 0; i < windows.size(); i++)
+    {
+        if (windows[i]->IsStale())
+            windows[i]->Refresh();
+    }
+}
+
+// FOR INTERNAL USE ONLY
+// Returns true if columns [x0, x1) of screen row sr are wholly covered by the windows above the i-th.
+bool MEBScreen::row_hidden(size_t i, int sr, int x0, int x1)
+{
+    cover.clear();
+    for (size_t j = i + 1; j < windows.size(); j++)
+    {
+        WINDOW *w = windows[j]->win;
+        if (w == nullptr)
+            continue;
+
+        int wy, wx, wrows, wcols;
+        getbegyx(w, wy, wx);
+        getmaxyx(w, wrows, wcols);
+        if (sr < wy || sr >= wy + wrows || wx >= x1 || wx + wcols <= x0)
+            continue;
+
+        // The common case: one window covers the whole row.
+        if (wx <= x0 && wx + wcols >= x1)
+            return true;
+        cover.push_back(std::make_pair(wx, wx + wcols));
+    }
+
+    // Only several windows together can cover what none covers alone.
+    if (cover.size() < 2)
+        return false;
+
+    std::sort(cover.begin(), cover.end());
+    int reach = x0;
+    for (size_t k = 0; k < cover.size() && cover[k].first <= reach; k++)
+        reach = std::max(reach, cover[k].second);
+    return reach >= x1;
+}
+
+// FOR INTERNAL USE ONLY
+// Copies every pending change into the virtual screen, bottom-most first. Damaged cells are repaired from stdscr, and
+// any window overlapping a row span written by something beneath it is re-copied over that span. Changed rows wholly
+// hidden by windows above are left unstaged; should they be exposed later, the damage retouches them.
+void MEBScreen::compose()
+{
+    reset_damage(false);
+
+    if (is_wintouched(stdscr))
+    {
+        for (int r = 0; r < LINES; r++)
+        {
+            if (is_linetouched(stdscr, r))
+            {
+                damage_lo[r] = 0;
+                damage_hi[r] = COLS - 1;
+            }
+        }
+        wnoutrefresh(stdscr);
+    }
+
+    for (int r = 0; r < LINES; r++)
+    {
+        if (damage_lo[r] <= damage_hi[r])
+        {
+            copywin(stdscr, newscr, r, damage_lo[r], r, damage_lo[r], r, damage_hi[r], FALSE);
+        }
+    }
+
+    for (size_t i = 0; i < windows.size(); i++)
+    {
+        WINDOW *w = windows[i]->win;
+        if (w == nullptr)
+            continue;
+
+        int wy, wx, wrows, wcols;
+        getbegyx(w, wy, wx);
+        getmaxyx(w, wrows, wcols);
+
+        for (int r = 0; r < wrows; r++)
+        {
+            int sr = wy + r;
+            if (sr < 0 || sr >= LINES)
+                continue;
+
+            if (damage_lo[sr] <= wx + wcols - 1 && damage_hi[sr] >= wx)
+            {
+                wtouchln(w, r, 1, 1);
+            }
+
+            if (is_linetouched(w, r))
+            {
+                int x0 = std::max(wx, 0);
+                int x1 = std::min(wx + wcols, COLS);
+                if (x0 >= x1 || (meb_damage_tracking && row_hidden(i, sr, x0, x1)))
+                {
+                    wtouchln(w, r, 1, 0);
+                    MEBStats::Get()->counters.rows_culled++;
+                    continue;
+                }
+
+                damage_lo[sr] = std::min(damage_lo[sr], std::max(wx, 0));
+                damage_hi[sr] = std::max(damage_hi[sr], std::min(wx + wcols, COLS) - 1);
+            }
+        }
+
+        if (is_wintouched(w))
+        {
+            windows[i]->counters.refreshes++;
+            MEBStats::Get()->counters.refreshes++;
+        }
+        wnoutrefresh(w);
+    }
+
+    reset_damage(true);
+}
+
 // To be called at the beginning of the program, initializes NCURSES-specific items.
-void ncurses_init(int timeout)
+void ncurses_init(int timeout, MEBRenderMode mode /* = MEB_RENDER_NCURSES */)
 {
     initscr();
     cbreak();
@@ -47,13 +449,62 @@ void ncurses_init(int timeout)
     keypad(stdscr, TRUE);
     wtimeout(stdscr, timeout);
     refresh();
+
+    use_renderer(mode, STDOUT_FILENO); // initscr() outputs to stdout.
 }
 
 // To be called at the end of the program, cleans up NCURSES-specific items.
 void ncurses_cleanup()
 {
+    if (meb_renderer != nullptr)
+    {
+        MEBScreen::Get()->SetRenderer(nullptr);
+        delete meb_renderer;
+        meb_renderer = nullptr;
+    }
+
     endwin();
     clear();
+
+    if (meb_headless != nullptr)
+    {
+        delscreen(meb_headless);
+        fclose(meb_headless_out);
+        fclose(meb_headless_in);
+        meb_headless = nullptr;
+    }
+}
+
+// Initializes NCURSES on a discarded output with no input, in place of ncurses_init(...).
+void ncurses_init_headless(int cols, int rows, MEBRenderMode mode /* = MEB_RENDER_NCURSES */)
+{
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%d", cols);
+    setenv("COLUMNS", buf, 1);
+    snprintf(buf, sizeof(buf), "%d", rows);
+    setenv("LINES", buf, 1);
+
+    meb_headless_out = fopen("/dev/null", "w");
+    meb_headless_in = fopen("/dev/null", "r");
+    if (meb_headless_out != nullptr && meb_headless_in != nullptr)
+        meb_headless = newterm("xterm", meb_headless_out, meb_headless_in);
+
+    if (meb_headless == nullptr)
+    {
+        if (meb_headless_out != nullptr)
+            fclose(meb_headless_out);
+        if (meb_headless_in != nullptr)
+            fclose(meb_headless_in);
+        throw std::runtime_error("Cannot open a headless screen.");
+    }
+
+    cbreak();
+    noecho();
+    keypad(stdscr, TRUE);
+    nodelay(stdscr, TRUE);
+    refresh();
+
+    use_renderer(mode, fileno(meb_headless_out));
 }
 
 // Spawns a MEBWindow.
@@ -76,9 +527,16 @@ MEBWindow::MEBWindow(int x, int y, int cols, int rows, const char *title, MEBWin
     this->x_ = x;
     this->y_ = y;
     this->parent = parent;
+    this->stale = false;
     this->cols_ = cols;
     this->rows_ = rows;
     strcpy(this->title, title);
+    this->counters = MEBCounters();
+
+    if (parent != nullptr)
+        parent->children.push_back(this);
+
+    MEBScreen::Get()->Register(this);
 
     instantiate_window();
 }
@@ -86,49 +544,126 @@ MEBWindow::MEBWindow(int x, int y, int cols, int rows, const char *title, MEBWin
 // Frees window memory; to be called by user at end of window use.
 MEBWindow::~MEBWindow()
 {
+    MEBScreen::Get()->Unregister(this);
+
+    if (parent != nullptr)
+        parent->children.erase(std::remove(parent->children.begin(), parent->children.end(), this), parent->children.end());
+
+    // Orphans stay where they were placed.
+    for (size_t i = 0; i < children.size(); i++)
+    {
+        MEBWindow *c = children[i];
+        c->x_ = c->screen_x();
+        c->y_ = c->screen_y();
+        c->parent = nullptr;
+    }
+    children.clear();
+
+    if (meb_damage_tracking)
+    {
+        int y, x, rows, cols;
+        getbegyx(win, y, x);
+        getmaxyx(win, rows, cols);
+        MEBScreen::Get()->Damage(x, y, cols, rows);
+        delete_win();
+        MEBScreen::Get()->Present();
+        return;
+    }
+
     destroy_window();
+    MEBScreen::Get()->Present();
     // free(this);
 }
 
+// Enables or disables damage-tracked updates for all MEBWindows.
+void MEBWindow::SetDamageTracking(bool enable)
+{
+    meb_damage_tracking = enable;
+}
+
+// Returns whether damage-tracked updates are enabled.
+bool MEBWindow::DamageTracking()
+{
+    return meb_damage_tracking;
+}
+
 // Moves a MEBWindow by some delta-x and delta-y.
 void MEBWindow::Move(int dx, int dy)
 {
+    this->counters.moves++;
     this->x_ += dx;
     this->y_ += dy;
 
+    invalidate_children();
     Refresh();
 }
 
 // Moves a MEBWindow to a specific location.
 void MEBWindow::MoveTo(int x, int y)
 {
+    this->counters.moves++;
     this->x_ = x;
     this->y_ = y;
 
+    invalidate_children();
     Refresh();
 }
 
 // Resizes a MEBWindow by some delta-width and delta-height.
 void MEBWindow::Resize(int dcols, int drows)
 {
+    this->counters.resizes++;
     this->cols_ += dcols;
     this->rows_ += drows;
 
+    invalidate_children();
     Refresh();
 }
 
 // Resizes a MEBWindow to a specific size.
 void MEBWindow::ResizeTo(int cols, int rows)
 {
+    this->counters.resizes++;
+    this->cols_ = cols;
+    this->rows_ = rows;
+
+    invalidate_children();
+    Refresh();
+}
+
+// Moves and resizes a MEBWindow at once.
+void MEBWindow::Place(int x, int y, int cols, int rows)
+{
+    if (x != this->x_ || y != this->y_)
+        this->counters.moves++;
+    if (cols != this->cols_ || rows != this->rows_)
+        this->counters.resizes++;
+
+    this->x_ = x;
+    this->y_ = y;
     this->cols_ = cols;
     this->rows_ = rows;
 
+    invalidate_children();
     Refresh();
 }
 
 // Refreshes a MEBWindow.
 void MEBWindow::Refresh()
 {
+    if (this->stale)
+    {
+        // Placed again as its parent moved, so its own children must follow.
+        this->stale = false;
+        invalidate_children();
+    }
+
+    if (meb_damage_tracking && this->win != nullptr)
+    {
+        update_window();
+        return;
+    }
+
     destroy_window();
     instantiate_window();
 }
@@ -136,15 +671,77 @@ void MEBWindow::Refresh()
 // FOR INTERNAL USE ONLY
 void MEBWindow::instantiate_window()
 {
-    if (this->parent == nullptr)
-    {
-        this->win = newwin(this->rows_, this->cols_, this->y_, this->x_);
-    }
-    else
+    this->win = newwin(this->rows_, this->cols_, screen_y(), screen_x());
+    this->counters.recreations++;
+    MEBStats::Get()->counters.windows_created++;
+
+    draw_frame();
+
+    MEBScreen::Get()->Present(); // Show that box.
+}
+
+// FOR INTERNAL USE ONLY
+// Moves and resizes the existing window in place, repairing whatever it no longer covers.
+void MEBWindow::update_window()
+{
+    int old_y, old_x, old_rows, old_cols;
+    getbegyx(this->win, old_y, old_x);
+    getmaxyx(this->win, old_rows, old_cols);
+
+    int new_x = screen_x();
+    int new_y = screen_y();
+
+    bool moved = (new_x != old_x) || (new_y != old_y);
+    bool resized = (this->cols_ != old_cols) || (this->rows_ != old_rows);
+
+    if (moved || resized)
     {
-        this->win = newwin(this->rows_, this->cols_, this->y_ + this->parent->y_, this->parent->x_ + this->parent->cols_);
+        MEBRect old_r = {old_x, old_y, old_cols, old_rows};
+        MEBRect new_r = {new_x, new_y, this->cols_, this->rows_};
+
+        // Shrink before moving and grow after, so the window never has to extend past the screen mid-update.
+        if (resized)
+            wresize(this->win, std::min(old_rows, this->rows_), std::min(old_cols, this->cols_));
+
+        if ((moved && mvwin(this->win, new_y, new_x) == ERR) || (resized && wresize(this->win, this->rows_, this->cols_) == ERR))
+        {
+            // The new geometry cannot be represented in place; fall back to recreating the window.
+            MEBScreen::Get()->Damage(old_r.x, old_r.y, old_r.cols, old_r.rows);
+            delete_win();
+            this->win = newwin(this->rows_, this->cols_, new_y, new_x);
+            this->counters.recreations++;
+            MEBStats::Get()->counters.windows_created++;
+            draw_frame();
+        }
+        else if (resized)
+        {
+            // Blank out the old border where it is now interior, then redraw the frame.
+            if (this->rows_ > old_rows)
+                mvwhline(this->win, old_rows - 1, 1, ' ', this->cols_ - 2);
+            if (this->cols_ > old_cols)
+                mvwvline(this->win, 1, old_cols - 1, ' ', this->rows_ - 2);
+            draw_frame();
+        }
+
+        MEBScreen::Get()->DamageExposed(old_r, new_r);
     }
 
+    MEBScreen::Get()->Present();
+}
+
+// Copies the window's cells into a cell grid.
+void MEBWindow::Snapshot(MEBCellBuffer &out)
+{
+    out.Resize(this->cols_, this->rows_);
+    out.Clear();
+    if (this->win != nullptr)
+        out.Capture(this->win, 0, 0);
+}
+
+// FOR INTERNAL USE ONLY
+// Draws the border, title and size indicator.
+void MEBWindow::draw_frame()
+{
     box(this->win, 0, 0); // 0, 0 gives default characters for the vertical and horizontal lines.
 
     // Draw the title.
@@ -152,16 +749,62 @@ void MEBWindow::instantiate_window()
 
     // Draw the window size.
     mvwprintw(this->win, this->rows_ - 1, this->cols_ - 10, " %dx%d ", this->cols_, this->rows_);
+}
+
+// Returns true if w is this window or one of its descendants.
+bool MEBWindow::Contains(MEBWindow *w)
+{
+    for (; w != nullptr; w = w->parent)
+    {
+        if (w == this)
+            return true;
+    }
+    return false;
+}
+
+// FOR INTERNAL USE ONLY
+// Marks the children to be placed again when the frame is output.
+void MEBWindow::invalidate_children()
+{
+    for (size_t i = 0; i < children.size(); i++)
+        children[i]->stale = true;
+}
 
-    wrefresh(this->win); // Show that box.
+// FOR INTERNAL USE ONLY
+// Child windows are placed to the right of their parent.
+int MEBWindow::screen_x()
+{
+    if (this->parent == nullptr)
+        return this->x_;
+
+    return this->parent->screen_x() + this->parent->cols_;
+}
+
+// FOR INTERNAL USE ONLY
+int MEBWindow::screen_y()
+{
+    if (this->parent == nullptr)
+        return this->y_;
+
+    return this->y_ + this->parent->screen_y();
 }
 
 // FOR INTERNAL USE ONLY
 void MEBWindow::destroy_window()
 {
     wborder(win, ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' '); // Erase frame around the window
-    wrefresh(win);                                        // Refresh it (to leave it blank)
-    delwin(win);                                          // and delete
+    wnoutrefresh(win);                                    // Stage it (to leave it blank)
+    delete_win();                                         // and delete
+}
+
+// FOR INTERNAL USE ONLY
+// Deletes the NCURSES window once every widget has let go of its sub-windows, which would otherwise keep it alive.
+void MEBWindow::delete_win()
+{
+    MEBScreen::Get()->Release(win);
+    if (delwin(win) == OK)
+        MEBStats::Get()->counters.windows_destroyed++;
+    win = nullptr;
 }
 
 
@@ -174,56 +817,205 @@ MEBMenu::MEBMenu(MEBWindow *w, int x, int y, int cols, int rows, int n_items, ch
     this->y = y;
     this->rows = rows;
     this->cols = cols;
-    this->n_items = n_items;
     this->parent = w;
+    this->posted_win = nullptr;
+    this->is_virtual = false;
+    this->sub = nullptr;
+    this->top = this->cur = 0;
+    this->nav_pos = this->nav_top = -1;
+    this->drawn_top = this->drawn_cur = -1;
+    this->filter_index = nullptr;
+    this->own_index = false;
+    this->index_stale = false;
+    this->filtered_gen = 0;
+    this->prompt_len = 0;
+    this->title_cols = 0;
 
-    this->items = (ITEM **)calloc(n_items, sizeof(ITEM *));
-    for (int i = 0; i < n_items; ++i)
+    // The strings are copied so items can later be edited without the caller's arrays.
+    for (int i = 0; i < n_items && item_titles[i] != NULL; ++i)
     {
-        this->items[i] = new_item(item_titles[i], item_desc[i]);
+        ITEM *item = new_item(strings.Strdup(item_titles[i]), strings.Strdup(item_desc[i]));
+        if (item == NULL)
+        {
+            for (size_t j = 0; j < items.size(); j++)
+                free_item(items[j]);
+            throw std::invalid_argument("Item titles must be non-empty and printable.");
+        }
+        this->items.push_back(item);
     }
+    this->n_items = items.size();
+    this->items.push_back(NULL);
+
+    InstantiateMenu();
+
+    MEBScreen::Get()->Register(this);
+}
+
+// Spawns a virtual menu.
+MEBMenu::MEBMenu(MEBWindow *w, int x, int y, int cols, int rows, int n_items, MEBMenuSource source, const char *mark)
+{
+    if (strlen(mark) >= MAX_MENU_MARK)
+        throw std::length_error("Mark length exceeds maximum.");
+
+    strcpy(this->mark, mark);
+    this->x = x;
+    this->y = y;
+    this->rows = rows;
+    this->cols = cols;
+    this->n_items = n_items;
+    this->parent = w;
+    this->posted_win = nullptr;
+    this->is_virtual = true;
+    this->source = source;
+    this->sub = nullptr;
+    this->menu = nullptr;
+    this->top = this->cur = 0;
+    this->nav_pos = this->nav_top = -1;
+    this->drawn_top = this->drawn_cur = -1;
+    this->filter_index = nullptr;
+    this->own_index = false;
+    this->index_stale = false;
+    this->filtered_gen = 0;
+    this->prompt_len = 0;
+    this->title_cols = (cols - (int)strlen(mark)) / 2;
+    this->line.resize(cols + 1);
 
     InstantiateMenu();
+
+    MEBScreen::Get()->Register(this);
 }
 
 void MEBMenu::InstantiateMenu()
 {
-    this->menu = new_menu((ITEM **)this->items);
+    if (is_virtual)
+    {
+        sub = derwin(parent->win, rows, cols, y, x);
+        posted_win = parent->win;
+        drawn_top = drawn_cur = -1;
+        MEBScreen::Get()->Present();
+        return;
+    }
+
+    this->menu = new_menu(&items[0]);
+    drawn_filter.clear(); // Any filter must be applied to the new menu.
+    sub = derwin(parent->win, rows, cols, y, x);
     set_menu_win(menu, parent->win);
-    set_menu_sub(menu, derwin(parent->win, rows, cols, y, x));
+    set_menu_sub(menu, sub);
+    set_menu_format(menu, rows, 1); // Scroll rather than refuse to post when there are more items than rows.
     set_menu_mark(menu, mark);
     post_menu(menu);
-    wrefresh(parent->win);
+    posted_win = parent->win;
+    MEBScreen::Get()->Present();
 }
 
 // Destructor.
 MEBMenu::~MEBMenu()
 {
+    MEBScreen::Get()->Unregister(this);
     DestroyMenu();
-    free(items);
+    if (own_index)
+        delete filter_index;
 }
 
 void MEBMenu::Move(int dx, int dy)
 {
+    counters.moves++;
     x += dx;
     y += dy;
 
     Refresh();
 };
 
+// Re-posts the menu if its parent's NCURSES window was recreated since it was last posted. Virtual menus also draw
+// whatever rows changed since the last frame here.
+void MEBMenu::Render()
+{
+    if (parent->win != nullptr && posted_win != parent->win)
+    {
+        Refresh();
+        settle();
+        return;
+    }
+
+    settle();
+    if (filter_index != nullptr)
+        sync_filter();
+
+    if (!is_virtual || sub == nullptr || (drawn_top == top && drawn_cur == cur))
+        return;
+
+    if (drawn_top != top)
+    {
+        for (int r = 0; r < rows; r++)
+            virtual_draw_row(top + r);
+    }
+    else
+    {
+        // Same page; only the old and new current rows change.
+        virtual_draw_row(drawn_cur);
+        virtual_draw_row(cur);
+    }
+
+    // The sub-window shares the parent's cells, but the parent must be told which of its lines changed.
+    wsyncup(sub);
+
+    drawn_top = top;
+    drawn_cur = cur;
+}
+
 void MEBMenu::Refresh()
 {
-    // destroy_menu();
+    if (is_virtual)
+    {
+        DestroyMenu();
+        InstantiateMenu();
+        return;
+    }
+
     unpost_menu(menu);
     free_menu(menu);
+    if (sub != nullptr)
+        delwin(sub);
     InstantiateMenu();
 }
 
+// Unposts the menu and deletes its sub-window if it was made from w.
+void MEBMenu::Release(WINDOW *w)
+{
+    if (sub == nullptr || posted_win != w)
+        return;
+
+    // The menu itself is kept, unposted, and posted again to the parent's next window.
+    if (!is_virtual)
+    {
+        unpost_menu(menu);
+        set_menu_sub(menu, NULL);
+        set_menu_win(menu, NULL);
+    }
+    delwin(sub);
+    sub = nullptr;
+    posted_win = nullptr;
+}
+
 // FOR INTERNAL USE ONLY
 void MEBMenu::DestroyMenu()
 {
+    if (is_virtual)
+    {
+        if (sub != nullptr)
+        {
+            werase(sub);
+            delwin(sub);
+            sub = nullptr;
+        }
+        return;
+    }
+
     unpost_menu(menu);
     free_menu(menu);
+    if (sub != nullptr)
+        delwin(sub);
+    sub = nullptr;
     for (int i = 0; i < n_items; ++i)
     {
         free_item(items[i]);
@@ -232,19 +1024,628 @@ void MEBMenu::DestroyMenu()
 
 int MEBMenu::Update(int in)
 {
-    switch(in)
+    if (filter_index != nullptr)
+    {
+        if (in >= ' ' && in < 127)
+        {
+            SetFilter((filter + (char)in).c_str());
+            return -1;
+        }
+        else if ((in == KEY_BACKSPACE || in == 127 || in == '\b') && !filter.empty())
+        {
+            SetFilter(filter.substr(0, filter.size() - 1).c_str());
+            return -1;
+        }
+        else if (in == 27 && !filter.empty())
+        {
+            SetFilter("");
+            return -1;
+        }
+    }
+
+    if (is_virtual)
+    {
+        switch (in)
+        {
+        case KEY_DOWN:
+            virtual_move(1);
+            break;
+        case KEY_UP:
+            virtual_move(-1);
+            break;
+        case KEY_NPAGE:
+            virtual_move(rows);
+            break;
+        case KEY_PPAGE:
+            virtual_move(-rows);
+            break;
+        case KEY_HOME:
+            JumpTo(0);
+            break;
+        case KEY_END:
+            virtual_move(view_count());
+            break;
+        case '\n':
+            return GetCurrent();
+        }
+
+        return -1;
+    }
+
+    switch (in)
     {
     case KEY_DOWN:
-        menu_driver(menu, REQ_DOWN_ITEM);
-        wrefresh(parent->win);
-        break;
     case KEY_UP:
-        menu_driver(menu, REQ_UP_ITEM);
-        wrefresh(parent->win);
+    case KEY_NPAGE:
+    case KEY_PPAGE:
+    case KEY_HOME:
+    case KEY_END:
+        navigate(in);
         break;
     case '\n':
-        return item_index(current_item(menu));
+        return GetCurrent();
     }
-    
+
     return -1;
+}
+
+// Makes an item current, scrolling it into view.
+void MEBMenu::JumpTo(int index)
+{
+    if (n_items <= 0)
+        return;
+
+    if (index < 0)
+        index = 0;
+    if (index >= n_items)
+        index = n_items - 1;
+
+    if (!is_virtual)
+    {
+        // Overrides any movement still to be applied.
+        nav_pos = nav_top = -1;
+
+        // Items hidden by the filter cannot be made current.
+        if (filter.empty() || std::binary_search(filtered.begin(), filtered.end(), index))
+            set_current_item(menu, items[index]);
+        MEBScreen::Get()->Present();
+        return;
+    }
+
+    // While filtering, go to the nearest matching item at or after index.
+    int pos = index;
+    if (!filter.empty())
+        pos = std::lower_bound(filtered.begin(), filtered.end(), index) - filtered.begin();
+
+    virtual_move(pos - cur);
+}
+
+// Changes the number of items in a virtual menu.
+void MEBMenu::SetCount(int n_items)
+{
+    if (!is_virtual)
+        return;
+
+    this->n_items = n_items;
+    if (cur >= view_count())
+        cur = view_count() > 0 ? view_count() - 1 : 0;
+    if (top > cur)
+        top = cur;
+    drawn_top = -1;
+    MEBScreen::Get()->Present();
+}
+
+// Sets the width of the title column of a virtual menu.
+void MEBMenu::SetTitleWidth(int title_cols)
+{
+    this->title_cols = title_cols;
+    drawn_top = -1;
+    MEBScreen::Get()->Present();
+}
+
+// Returns the index of the current item.
+int MEBMenu::GetCurrent()
+{
+    if (view_count() <= 0)
+        return -1;
+
+    if (is_virtual)
+        return view_item(cur);
+
+    settle();
+
+    // ncurses renumbers items when they are set, so while filtering the index is a position among the matches.
+    ITEM *item = current_item(menu);
+    if (item == NULL)
+        return -1;
+    return view_item(item_index(item));
+}
+
+// Enables type-ahead filtering.
+void MEBMenu::EnableTypeAhead(MEBSearchIndex *index /* = nullptr */)
+{
+    if (index == nullptr)
+    {
+        if (is_virtual)
+            throw std::invalid_argument("Virtual menus require a search index.");
+
+        filter_index = new MEBSearchIndex();
+        own_index = true;
+        build_own_index();
+        return;
+    }
+
+    filter_index = index;
+}
+
+// Sets the filter text directly.
+void MEBMenu::SetFilter(const char *text)
+{
+    if (filter_index == nullptr || filter == text)
+        return;
+
+    settle();
+    filter = text;
+    if (!filter.empty())
+    {
+        if (index_stale)
+            build_own_index();
+        filter_index->Query(filter.c_str());
+    }
+
+    MEBScreen::Get()->Present();
+}
+
+// Inserts an item into a classic menu.
+void MEBMenu::InsertItem(int index, const char *title, const char *desc)
+{
+    if (is_virtual)
+        throw std::logic_error("Virtual menus are edited through their source.");
+    if (index < 0 || index > n_items)
+        throw std::out_of_range("Item index out of range.");
+
+    settle();
+
+    char *t = strings.Strdup(title);
+    char *d = strings.Strdup(desc);
+    ITEM *item = new_item(t, d);
+    if (item == NULL)
+    {
+        strings.Free(t);
+        strings.Free(d);
+        throw std::invalid_argument("Item titles must be non-empty and printable.");
+    }
+
+    ITEM *was = menu_items(menu) != NULL ? current_item(menu) : NULL;
+    int was_top = top_row(menu);
+
+    if (filter.empty())
+    {
+        // ncurses walks the list it was given when relinking, so it must let go of it before it changes.
+        unpost_menu(menu);
+        set_menu_items(menu, NULL);
+    }
+    items.insert(items.begin() + index, item);
+    n_items++;
+
+    if (filter.empty())
+        relink(&items[0], was, was_top);
+    reindex();
+}
+
+// Removes an item from a classic menu.
+void MEBMenu::RemoveItem(int index)
+{
+    if (is_virtual)
+        throw std::logic_error("Virtual menus are edited through their source.");
+    if (index < 0 || index >= n_items)
+        throw std::out_of_range("Item index out of range.");
+
+    settle();
+
+    ITEM *gone = items[index];
+    ITEM *was = menu_items(menu) != NULL ? current_item(menu) : NULL;
+    int was_top = top_row(menu);
+
+    if (filter.empty())
+    {
+        unpost_menu(menu);
+        set_menu_items(menu, NULL);
+    }
+    items.erase(items.begin() + index);
+    n_items--;
+
+    if (filter.empty())
+    {
+        if (was == gone)
+            was = items[std::min(index, std::max(n_items - 1, 0))];
+        relink(&items[0], was, was_top);
+    }
+    reindex();
+
+    // The item is no longer connected to the menu, so it can now be freed.
+    char *t = (char *)item_name(gone);
+    char *d = (char *)item_description(gone);
+    free_item(gone);
+    strings.Free(t);
+    strings.Free(d);
+}
+
+// Replaces the text of an item of a classic menu in place.
+void MEBMenu::SetItem(int index, const char *title, const char *desc)
+{
+    if (is_virtual)
+        throw std::logic_error("Virtual menus are edited through their source.");
+    if (index < 0 || index >= n_items)
+        throw std::out_of_range("Item index out of range.");
+    if (title == NULL || *title == '\0')
+        throw std::invalid_argument("Item titles must be non-empty and printable.");
+
+    settle();
+
+    ITEM *item = items[index];
+    char *old_t = (char *)item->name.str;
+    char *old_d = (char *)item->description.str;
+
+    // ncurses has no call to rename an item, but its fields are public.
+    item->name.str = strings.Strdup(title);
+    item->name.length = strlen(item->name.str);
+    item->description.str = strings.Strdup(desc);
+    item->description.length = strlen(item->description.str);
+
+    // While filtering, the item may also have entered or left the matches; the menu is relinked over them.
+    reindex();
+
+    if (!filter.empty())
+    {
+        // Already redrawn.
+    }
+    else if (item->name.length > (unsigned)menu->namelen || item->description.length > (unsigned)menu->desclen)
+    {
+        // Wider than the columns ncurses laid out; have it measure again.
+        ITEM *was = current_item(menu);
+        int was_top = top_row(menu);
+        unpost_menu(menu);
+        relink(&items[0], was, was_top);
+    }
+    else if (index >= top_row(menu) && index < top_row(menu) + rows)
+    {
+        // Redraw the visible rows; only the edited one differs, so only it is sent to the terminal.
+        unpost_menu(menu);
+        post_menu(menu);
+        MEBScreen::Get()->Present();
+    }
+
+    strings.Free(old_t);
+    strings.Free(old_d);
+}
+
+// Redraws one item of a virtual menu.
+void MEBMenu::InvalidateItem(int index)
+{
+    if (!is_virtual || sub == nullptr)
+        return;
+
+    int pos = index;
+    if (!filter.empty())
+    {
+        std::vector<int>::iterator it = std::lower_bound(filtered.begin(), filtered.end(), index);
+        if (it == filtered.end() || *it != index)
+            return;
+        pos = it - filtered.begin();
+    }
+
+    // Rows waiting on a full redraw are drawn by Render() anyway.
+    if (drawn_top != top || pos < top || pos >= top + rows)
+        return;
+
+    virtual_draw_row(pos);
+    wsyncup(sub);
+    MEBScreen::Get()->Present();
+}
+
+// FOR INTERNAL USE ONLY
+// Points an unposted classic menu at a NULL-terminated list and posts it again, keeping the scroll position and, if it
+// is listed, the current item in view.
+void MEBMenu::relink(ITEM **list, ITEM *keep, int keep_top)
+{
+    if (*list == NULL)
+    {
+        // ncurses will not post an empty menu; detach the items so none is left referenced, and leave it blank.
+        set_menu_items(menu, NULL);
+        MEBScreen::Get()->Present();
+        return;
+    }
+
+    set_menu_items(menu, list);
+    set_menu_format(menu, rows, 1); // Refused while a menu has no items, so applied on every relink.
+
+    int count = item_count(menu);
+    int keep_pos = -1;
+    for (int i = 0; keep != NULL && i < count; i++)
+    {
+        if (list[i] == keep)
+        {
+            keep_pos = i;
+            break;
+        }
+    }
+
+    if (keep_top > count - rows)
+        keep_top = count - rows;
+    if (keep_top < 0)
+        keep_top = 0;
+    if (keep_pos >= 0 && keep_pos < keep_top)
+        keep_top = keep_pos;
+    else if (keep_pos >= keep_top + rows)
+        keep_top = keep_pos - rows + 1;
+
+    set_top_row(menu, keep_top);
+    if (keep_pos >= 0)
+        set_current_item(menu, keep);
+    post_menu(menu);
+    MEBScreen::Get()->Present();
+}
+
+// FOR INTERNAL USE ONLY
+// (Re)builds the index a classic menu owns over its items.
+void MEBMenu::build_own_index()
+{
+    filter_index->Build(n_items, [this](int i, const char **title, const char **desc)
+                        {
+        *title = item_name(items[i]);
+        *desc = item_description(items[i]); });
+    index_stale = false;
+}
+
+// FOR INTERNAL USE ONLY
+// Brings the filter up to date after a classic menu's items were edited. An owned index is only rebuilt once a filter
+// needs it, so editing an unfiltered menu costs nothing here.
+void MEBMenu::reindex()
+{
+    if (filter_index == nullptr)
+        return;
+
+    if (own_index)
+        index_stale = true;
+    if (filter.empty())
+        return;
+
+    if (own_index)
+        build_own_index();
+    filter_index->Query(filter.c_str());
+    sync_filter();
+}
+
+// FOR INTERNAL USE ONLY
+// Number of items shown: all of them, or those matching the filter.
+int MEBMenu::view_count()
+{
+    return filter.empty() ? n_items : (int)filtered.size();
+}
+
+// FOR INTERNAL USE ONLY
+// Item index of a shown position.
+int MEBMenu::view_item(int pos)
+{
+    return filter.empty() ? pos : filtered[pos];
+}
+
+// FOR INTERNAL USE ONLY
+// Picks up any new filter results and re-lays the menu out over them.
+void MEBMenu::sync_filter()
+{
+    bool changed = (filter != drawn_filter);
+    if (!filter.empty())
+        changed |= filter_index->Fetch(filtered, filtered_gen);
+
+    if (!changed)
+        return;
+
+    // A new filter starts a virtual menu from the top; more results for the same filter keep the selection.
+    if (filter != drawn_filter)
+        cur = top = 0;
+    drawn_filter = filter;
+
+    if (is_virtual)
+    {
+        if (cur >= view_count())
+            cur = view_count() > 0 ? view_count() - 1 : 0;
+        if (top > cur)
+            top = cur;
+        drawn_top = -1;
+    }
+    else
+    {
+        // Keep the current item selected if it survives the new filter.
+        ITEM *was = menu_items(menu) != NULL ? current_item(menu) : NULL;
+
+        unpost_menu(menu);
+        set_menu_items(menu, NULL); // Before filtered_items changes under it.
+        if (filter.empty())
+        {
+            relink(&items[0], was, 0);
+        }
+        else
+        {
+            filtered_items.clear();
+            for (size_t i = 0; i < filtered.size(); i++)
+                filtered_items.push_back(items[filtered[i]]);
+            filtered_items.push_back(NULL);
+            relink(&filtered_items[0], was, 0);
+        }
+    }
+
+    draw_filter_prompt();
+}
+
+// FOR INTERNAL USE ONLY
+// Shows the filter, and the number of matches, on the parent window's bottom border.
+void MEBMenu::draw_filter_prompt()
+{
+    int prow = parent->Rows() - 1;
+
+    if (prompt_len > 0)
+        mvwhline(parent->win, prow, 2, ACS_HLINE, prompt_len);
+
+    if (filter.empty())
+    {
+        prompt_len = 0;
+        return;
+    }
+
+    char buf[96];
+    snprintf(buf, sizeof(buf), " /%.40s (%d%s) ", filter.c_str(), view_count(), filter_index->Complete() ? "" : "...");
+
+    // Keep clear of the window size shown in the bottom-right corner.
+    prompt_len = std::min((int)strlen(buf), parent->Cols() - 14);
+    if (prompt_len > 0)
+        mvwaddnstr(parent->win, prow, 2, buf, prompt_len);
+}
+
+// FOR INTERNAL USE ONLY
+// Moves the current item of a virtual menu, scrolling by the minimum needed to keep it visible.
+void MEBMenu::virtual_move(int delta)
+{
+    if (view_count() <= 0)
+        return;
+
+    cur += delta;
+    if (cur < 0)
+        cur = 0;
+    if (cur >= view_count())
+        cur = view_count() - 1;
+
+    if (cur < top)
+        top = cur;
+    else if (cur >= top + rows)
+        top = cur - rows + 1;
+
+    MEBScreen::Get()->Present();
+}
+
+// FOR INTERNAL USE ONLY
+// Folds a navigation key into the classic menu's pending movement, as menu_driver(...) would have moved it.
+void MEBMenu::navigate(int in)
+{
+    int count = item_count(menu);
+    if (count <= 0)
+        return;
+
+    if (nav_pos < 0)
+    {
+        nav_pos = item_index(current_item(menu));
+        nav_top = top_row(menu);
+    }
+
+    int shown = std::min(rows, count);
+    int last_top = count - shown;
+    switch (in)
+    {
+    case KEY_DOWN:
+        nav_pos++;
+        break;
+    case KEY_UP:
+        nav_pos--;
+        break;
+    case KEY_NPAGE:
+        // As REQ_SCR_DPAGE, which moves the current item along with the page, or the last item on the last page.
+        if (nav_top < last_top)
+        {
+            int d = std::min(shown, last_top - nav_top);
+            nav_top += d;
+            nav_pos += d;
+        }
+        else
+            nav_pos = count - 1;
+        break;
+    case KEY_PPAGE:
+        if (nav_top > 0)
+        {
+            int d = std::min(shown, nav_top);
+            nav_top -= d;
+            nav_pos -= d;
+        }
+        else
+            nav_pos = 0;
+        break;
+    case KEY_HOME:
+        nav_pos = 0;
+        break;
+    case KEY_END:
+        nav_pos = count - 1;
+        break;
+    }
+
+    nav_pos = std::max(std::min(nav_pos, count - 1), 0);
+    if (nav_pos < nav_top)
+        nav_top = nav_pos;
+    else if (nav_pos >= nav_top + shown)
+        nav_top = nav_pos - shown + 1;
+
+    MEBScreen::Get()->Present();
+}
+
+// FOR INTERNAL USE ONLY
+// Applies the classic menu's pending movement, redrawing it once however many keys were folded into it.
+void MEBMenu::settle()
+{
+    if (is_virtual || nav_pos < 0)
+        return;
+
+    int pos = nav_pos;
+    int t = nav_top;
+    nav_pos = nav_top = -1;
+
+    ITEM **list = menu_items(menu);
+    int count = item_count(menu);
+    if (list == NULL || count <= 0)
+        return;
+    pos = std::min(pos, count - 1);
+
+    // Each call redraws the menu, so neither is made unless something moved.
+    if (t != top_row(menu) && t <= count - std::min(rows, count))
+        set_top_row(menu, t);
+    if (list[pos] != current_item(menu))
+        set_current_item(menu, list[pos]);
+}
+
+// FOR INTERNAL USE ONLY
+// Fetches and draws the item at one position of a virtual menu, if it is visible.
+void MEBMenu::virtual_draw_row(int pos)
+{
+    int r = pos - top;
+    if (r < 0 || r >= rows)
+        return;
+
+    if (pos >= view_count())
+    {
+        wmove(sub, r, 0);
+        wclrtoeol(sub);
+        return;
+    }
+
+    const char *title = "";
+    const char *desc = "";
+    source(view_item(pos), &title, &desc);
+    if (title == NULL)
+        title = "";
+    if (desc == NULL)
+        desc = "";
+
+    int mark_len = strlen(mark);
+    snprintf(&line[0], line.size(), "%-*s%-*.*s %s", mark_len, pos == cur ? mark : "", title_cols, title_cols, title, desc);
+
+    // Pad to the full width so the highlight, and any overwritten text, covers the row.
+    int len = strlen(&line[0]);
+    for (int i = len; i < cols; i++)
+        line[i] = ' ';
+    line[cols] = '\0';
+
+    mvwaddnstr(sub, r, 0, &line[0], mark_len);
+    if (pos == cur)
+        wattron(sub, A_STANDOUT);
+    waddnstr(sub, &line[mark_len], cols - mark_len);
+    if (pos == cur)
+        wattroff(sub, A_STANDOUT);
 }
\ No newline at end of file